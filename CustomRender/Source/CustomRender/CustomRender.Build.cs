@@ -54,7 +54,8 @@ public class CustomRender : ModuleRules
                 "MovieSceneTools",
                 "MovieSceneTracks",
                 "CinematicCamera",
-                "AssetRegistry"
+                "AssetRegistry",
+                "Json"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
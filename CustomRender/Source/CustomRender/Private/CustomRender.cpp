@@ -1,18 +1,37 @@
 #include "CustomRender.h"
 #include "CustomRenderStyle.h"
 #include "CustomRenderCommands.h"
+#include "CustomRenderKeys.h"
+#include "SCustomRenderActorList.h"
+#include "CustomRenderAssetFactory.h"
+#include "CustomRenderBoundsCache.h"
+#include "CustomRenderProfiler.h"
+#include "OrbitCore/OrbitTrajectory.h"
+#include "OrbitCore/OrbitBatch.h"
+#include "OrbitCore/OrbitKeyReduction.h"
+#include "OrbitCore/OrbitManifest.h"
+#include "OrbitCore/OrbitCoverage.h"
+#include "OrbitCore/OrbitCluster.h"
+#include "OrbitCore/OrbitVisibility.h"
 #include "Misc/MessageDialog.h"
 #include "Framework/MultiBox/MultiBoxBuilder.h"
 
 #include "LevelEditor.h"
+#include "Editor.h"
+#include "Editor/Transactor.h"
 
-SWindow * pwindow = nullptr;
 TArray<AActor*> selectedActors;
+TArray<FCustomRenderTarget> selectedTargets;
 
 static const FName CustomRenderTabName("CustomRender");
 
+/** Context of the undo transaction of a generation run, tells it apart from every other editor transaction */
+static const TCHAR* GenerationTransactionContext = TEXT("CustomRenderGenerate");
+
 #define LOCTEXT_NAMESPACE "FCustomRenderModule"
 
+const FName FCustomRenderModule::CameraTag("CustomRenderCamera");
+
 void FCustomRenderModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
@@ -22,6 +41,9 @@ void FCustomRenderModule::StartupModule()
 
 	FCustomRenderCommands::Register();
 
+	FCustomRenderAssetFactory::Initialize();
+	FCustomRenderBoundsCache::Initialize();
+
 	PluginCommands = MakeShareable(new FUICommandList);
 
 	PluginCommands->MapAction(
@@ -59,6 +81,42 @@ void FCustomRenderModule::ShutdownModule()
 	FCustomRenderStyle::Shutdown();
 
 	FCustomRenderCommands::Unregister();
+
+	FCustomRenderAssetFactory::Shutdown();
+	FCustomRenderBoundsCache::Shutdown();
+
+	if (GEditor) {
+		GEditor->UnregisterForUndo(this);
+	}
+}
+
+void FCustomRenderModule::PostUndo(bool bSuccess)
+{
+	// The transaction just undone is the first one that can be redone
+	if (bSuccess && GEditor && GEditor->Trans) {
+		OnGenerationUndoRedo(GEditor->Trans->GetRedoContext());
+	}
+}
+
+void FCustomRenderModule::PostRedo(bool bSuccess)
+{
+	// The transaction just redone is the first one that can be undone again
+	if (bSuccess && GEditor && GEditor->Trans) {
+		OnGenerationUndoRedo(GEditor->Trans->GetUndoContext(false));
+	}
+}
+
+void FCustomRenderModule::OnGenerationUndoRedo(const FTransactionContext& context)
+{
+	// Unrelated transactions leave the shots alone, their sequences still bind the cameras
+	if (context.Context != GenerationTransactionContext) return;
+
+	// The transaction itself put the sequences and cameras back: cameras spawned by the run are gone again,
+	// pooled ones it took are hidden again. Only the bookkeeping no longer matches, the next run rebuilds the
+	// shots and finds the tagged cameras of the level again.
+	ShotRecords.Reset();
+	PooledCameras.Reset();
+	OwnedCameras.Reset();
 }
 
 void FCustomRenderModule::AddMenuExtension(FMenuBuilder& Builder)
@@ -71,12 +129,16 @@ void FCustomRenderModule::AddToolbarExtension(FToolBarBuilder& Builder)
 	Builder.AddToolBarButton(FCustomRenderCommands::Get().PluginAction);
 }
 
-#include <string>
-#include <map>
 #include <vector>
 #include <algorithm>
 #include <EngineUtils.h>
-#include <Editor.h>
+#include <Async/ParallelFor.h>
+#include <Async/Async.h>
+#include <Misc/ScopedSlowTask.h>
+#include <Misc/Paths.h>
+#include <HAL/FileManager.h>
+#include <Misc/FileHelper.h>
+#include <ScopedTransaction.h>
 #include <ObjectTools.h>
 #include <AssetDeleteModel.h>
 
@@ -85,6 +147,7 @@ void FCustomRenderModule::AddToolbarExtension(FToolBarBuilder& Builder)
 #include <Runtime/Slate/Public/Widgets/Layout/SScrollBox.h>
 #include <Runtime/Engine/Classes/Engine/Selection.h>
 #include <Runtime/Engine/Classes/Engine/StaticMeshActor.h>
+#include <Runtime/Engine/Classes/Components/InstancedStaticMeshComponent.h>
 #include <Runtime/CinematicCamera/Public/CineCameraActor.h>
 #include <Runtime/CinematicCamera/Public/CineCameraComponent.h>
 #include <Runtime/LevelSequence/Public/LevelSequence.h>
@@ -103,19 +166,287 @@ void FCustomRenderModule::AddToolbarExtension(FToolBarBuilder& Builder)
 #include <Runtime/MovieScene/Public/Channels/MovieSceneFloatChannel.h>
 #include <Runtime/MovieScene/Public/Channels/MovieSceneChannelProxy.h>
 #include <Runtime/MovieSceneTracks/Public/Tracks/MovieScene3DTransformTrack.h>
+#include <Runtime/MovieSceneTracks/Public/Tracks/MovieSceneSubTrack.h>
 #include <Runtime/MovieSceneTracks/Public/Sections/MovieSceneCameraCutSection.h>
 #include <Runtime/MovieSceneTracks/Public/Sections/MovieScene3DTransformSection.h>
 
+DEFINE_LOG_CATEGORY_STATIC(LogCustomRender, Log, All);
+
 FFrameTime lastTime(0);
 
-void allChildWidgets(std::vector<TSharedRef<SWidget>> & result, TSharedRef<SWidget> parent) {
-	for (int i = 0; i < parent->GetChildren()->Num(); i++) {
-		auto child = parent->GetChildren()->GetChildAt(i);
-		result.push_back(child);
-		allChildWidgets(result, child);
+static const TCHAR* SequencePackagePath = TEXT("/Game/Cinematics/Sequences");
+static const TCHAR* ShardPrefix = TEXT("Master_Shard");
+
+static ULevelSequence* FindSequence(const FString& AssetName)
+{
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::GetModuleChecked<FAssetRegistryModule>("AssetRegistry");
+	FString AssetPath = SequencePackagePath;
+	AssetPath /= AssetName; AssetPath += "." + AssetName;
+	FAssetData AssetData = AssetRegistryModule.Get().GetAssetByObjectPath(*AssetPath);
+
+	return AssetData.IsValid() ? Cast<ULevelSequence>(AssetData.GetAsset()) : nullptr;
+}
+
+static ULevelSequence* FindMasterSequence()
+{
+	return FindSequence(TEXT("Master"));
+}
+
+static FString GetShardName(int32 ShardIndex)
+{
+	return FString::Printf(TEXT("%s%04d"), ShardPrefix, ShardIndex);
+}
+
+/** Every shard sequence left in the sequences folder, by shard index */
+static TMap<int32, ULevelSequence*> FindShardSequences()
+{
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::GetModuleChecked<FAssetRegistryModule>("AssetRegistry");
+	TArray<FAssetData> Assets;
+	AssetRegistryModule.Get().GetAssetsByPath(SequencePackagePath, Assets);
+
+	TMap<int32, ULevelSequence*> Shards;
+	for (const FAssetData& AssetData : Assets)
+	{
+		const FString AssetName = AssetData.AssetName.ToString();
+		if (!AssetName.StartsWith(ShardPrefix)) continue;
+
+		if (ULevelSequence* Shard = Cast<ULevelSequence>(AssetData.GetAsset())) {
+			Shards.Add(FCString::Atoi(*AssetName.RightChop(FCString::Strlen(ShardPrefix))), Shard);
+		}
+	}
+	return Shards;
+}
+
+static ISequencer* FindMasterSequencer(ULevelSequence* MasterSequenceAsset)
+{
+	IAssetEditorInstance* AssetEditor = MasterSequenceAsset ? FAssetEditorManager::Get().FindEditorForAsset(MasterSequenceAsset, false) : nullptr;
+	FLevelSequenceEditorToolkit* LevelSequenceEditor = (FLevelSequenceEditorToolkit*)AssetEditor;
+	return LevelSequenceEditor ? LevelSequenceEditor->GetSequencer().Get() : nullptr;
+}
+
+ACineCameraActor* FCustomRenderModule::AcquireCamera(UWorld* world, const FCustomRenderTarget& target)
+{
+	const FString label = target.GetLabel();
+	FVector CamPos = target.GetTransform().GetLocation();
+	FRotator CamRotation(0, 0, 0);
+
+	// Prefer the camera last set up for this target, then any camera of this level
+	ACineCameraActor* camera = nullptr;
+	for (auto pooled = PooledCameras.Find(target); pooled && !camera; pooled = PooledCameras.Find(target))
+	{
+		TWeakObjectPtr<ACineCameraActor> found = *pooled;
+		PooledCameras.RemoveSingle(target, found);
+		if (found.IsValid() && found->GetWorld() == world) camera = found.Get();
+	}
+	for (auto It = PooledCameras.CreateIterator(); It && !camera; ++It)
+	{
+		if (!It.Value().IsValid()) {
+			It.RemoveCurrent();
+		}
+		else if (It.Value()->GetWorld() == world) {
+			camera = It.Value().Get();
+			It.RemoveCurrent();
+		}
+	}
+
+	if (camera)
+	{
+		FCustomRenderProfiler::AddCameras(0, 1);
+
+		camera->Modify();
+		if (camera->GetActorLabel() != label) {
+			camera->SetActorLabel(label, false);
+		}
+		camera->SetActorLocationAndRotation(CamPos, CamRotation);
+		camera->SetActorHiddenInGame(false);
+		camera->bHiddenEd = false;
+		camera->MarkComponentsRenderStateDirty();
+		return camera;
+	}
+
+	// Create camera. The object name is made unique up front so the label doesn't have to rename the
+	// actor, and construction is deferred until the camera is fully set up.
+	FActorSpawnParameters CamSpawnInfo;
+	CamSpawnInfo.Name = MakeUniqueObjectName(world->GetCurrentLevel(), ACineCameraActor::StaticClass(), MakeObjectNameFromDisplayLabel(label, NAME_None));
+	CamSpawnInfo.bDeferConstruction = true;
+
+	camera = world->SpawnActor<ACineCameraActor>(CamPos, CamRotation, CamSpawnInfo);
+	camera->SetActorLabel(label, false);
+	camera->Tags.Add(CameraTag);
+	camera->FinishSpawning(FTransform(CamRotation, CamPos));
+	FindOwnedCameras(world).Add(camera);
+	FCustomRenderProfiler::AddCameras(1, 0);
+	return camera;
+}
+
+void FCustomRenderModule::ReleaseCamera(ACineCameraActor* camera, const FCustomRenderTarget& target)
+{
+	// Pooled cameras stay in the level, hidden and without any per tick work. bHiddenEd is saved with
+	// the level, unlike the temporary editor visibility, so they stay hidden after it is reloaded.
+	camera->Modify();
+	camera->LookatTrackingSettings.bEnableLookAtTracking = false;
+	camera->LookatTrackingSettings.bDrawDebugLookAtTrackingPosition = false;
+	camera->SetActorHiddenInGame(true);
+	camera->bHiddenEd = true;
+	camera->MarkComponentsRenderStateDirty();
+	PooledCameras.Add(target, camera);
+}
+
+void FCustomRenderModule::TrimCameraPool(UWorld* world)
+{
+	auto & owned = FindOwnedCameras(world);
+	for (auto It = PooledCameras.CreateIterator(); It; ++It)
+	{
+		ACineCameraActor* camera = It.Value().Get();
+		if (camera && camera->GetWorld() != world) continue;
+
+		if (camera) {
+			owned.Remove(camera);
+			world->EditorDestroyActor(camera, true);
+		}
+		It.RemoveCurrent();
+	}
+}
+
+void FCustomRenderModule::DestroyCameras(UWorld* world)
+{
+	// The shots lose their cameras, the next run can't be incremental
+	ShotRecords.Reset();
+	TrimCameraPool(world);
+
+	auto & owned = FindOwnedCameras(world);
+	for (auto & camera : owned)
+	{
+		if (camera.IsValid()) {
+			world->EditorDestroyActor(camera.Get(), true);
+		}
+	}
+	owned.Reset();
+}
+
+TArray<TWeakObjectPtr<ACineCameraActor>>& FCustomRenderModule::FindOwnedCameras(UWorld* world)
+{
+	// Levels closed since then drop out of the registry
+	for (auto It = OwnedCameras.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid()) {
+			It.RemoveCurrent();
+		}
+	}
+
+	TArray<TWeakObjectPtr<ACineCameraActor>>* cameras = OwnedCameras.Find(world);
+	if (!cameras)
+	{
+		// Tagged cameras of a previous session, or of this level before it was reloaded
+		cameras = &OwnedCameras.Add(world);
+		for (TActorIterator<ACineCameraActor> ActorItr(world); ActorItr; ++ActorItr) {
+			if (ActorItr->Tags.Contains(CameraTag)) {
+				cameras->Add(*ActorItr);
+			}
+		}
+	}
+	return *cameras;
+}
+
+// Fixed values for: Sony IMX258 sensor
+static const float SensorWidth = 4.69469f;
+static const float SensorHeight = 3.518753f;
+
+/** Write the camera manifest, and its CSV copy when asked, to Saved/CustomRender */
+static void WriteCameraManifest(const std::vector<OrbitCore::ManifestCamera>& cameras, const std::vector<std::string>& names, float fps, bool bCsv)
+{
+	const FString Directory = FPaths::ProjectSavedDir() / TEXT("CustomRender");
+
+	auto Write = [&](const FString& FileName, auto WriteRecords)
+	{
+		const FString Path = Directory / FileName;
+		TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*Path));
+		if (!Ar)
+		{
+			UE_LOG(LogCustomRender, Error, TEXT("Can't write the camera manifest %s"), *Path);
+			return;
+		}
+		WriteRecords([&](const void* Data, size_t Size) { Ar->Serialize(const_cast<void*>(Data), int64(Size)); });
+	};
+
+	Write(TEXT("CameraManifest.bin"), [&](auto Sink) { OrbitCore::WriteManifest(cameras, names, fps, Sink); });
+	if (bCsv)
+	{
+		Write(TEXT("CameraManifest.csv"), [&](auto Sink) { OrbitCore::WriteManifestCsv(cameras, names, Sink); });
+	}
+}
+
+/** Write which targets every shot covers to Saved/CustomRender/ShotTargets.csv */
+static void WriteShotTargets(const TArray<FCustomRenderShotRecord>& records)
+{
+	FString Csv = TEXT("Shot,Shard,Camera,Targets") LINE_TERMINATOR;
+	for (int32 i = 0; i < records.Num(); i++)
+	{
+		const FCustomRenderShotRecord& record = records[i];
+
+		FString Members;
+		for (const auto& member : record.Members)
+		{
+			if (!member.IsValid()) continue;
+			if (!Members.IsEmpty()) Members += TEXT(";");
+			Members += member.GetLabel();
+		}
+
+		const FString Camera = record.Camera.IsValid() ? record.Camera->GetActorLabel() : FString();
+		Csv += FString::Printf(TEXT("%d,%d,\"%s\",\"%s\"") LINE_TERMINATOR, i, record.Shard, *Camera, *Members);
+	}
+
+	const FString Path = FPaths::ProjectSavedDir() / TEXT("CustomRender") / TEXT("ShotTargets.csv");
+	if (!FFileHelper::SaveStringToFile(Csv, *Path))
+	{
+		UE_LOG(LogCustomRender, Error, TEXT("Can't write the shot targets %s"), *Path);
+	}
+}
+
+/** Write the visibility of every shot, before and after adjusting it, to Saved/CustomRender/Visibility.csv */
+static void WriteVisibilityReport(const TArray<FCustomRenderTarget>& shotTargets, const std::vector<float>& traced, const std::vector<float>& visibility, const std::vector<const TCHAR*>& actions)
+{
+	FString Csv = TEXT("Shot,Target,TracedVisibility,Visibility,Action") LINE_TERMINATOR;
+	for (int32 i = 0; i < shotTargets.Num(); i++)
+	{
+		Csv += FString::Printf(TEXT("%d,\"%s\",%.3f,%.3f,%s") LINE_TERMINATOR, i, *shotTargets[i].GetLabel(), traced[i], visibility[i], actions[i]);
+	}
+
+	const FString Path = FPaths::ProjectSavedDir() / TEXT("CustomRender") / TEXT("Visibility.csv");
+	if (!FFileHelper::SaveStringToFile(Csv, *Path))
+	{
+		UE_LOG(LogCustomRender, Error, TEXT("Can't write the visibility report %s"), *Path);
 	}
 }
 
+/** Spin box bound to a global setting */
+static TSharedRef<SWidget> GlobalFloatEditor(float * value, float minValue, float maxValue)
+{
+	return SNew(SSpinBox<float>)
+		.MinValue(minValue)
+		.MaxValue(maxValue)
+		.Value_Lambda([value]() { return *value; })
+		.OnValueChanged_Lambda([value](float newValue) { *value = newValue; });
+}
+
+/** Integer spin box bound to a global setting */
+static TSharedRef<SWidget> GlobalIntEditor(int32 * value, int32 minValue, int32 maxValue)
+{
+	return SNew(SSpinBox<int32>)
+		.MinValue(minValue)
+		.MaxValue(maxValue)
+		.Value_Lambda([value]() { return *value; })
+		.OnValueChanged_Lambda([value](int32 newValue) { *value = newValue; });
+}
+
+/** Check box bound to a global setting */
+static TSharedRef<SWidget> GlobalBoolEditor(bool * value)
+{
+	return SNew(SCheckBox)
+		.IsChecked_Lambda([value]() { return *value ? ECheckBoxState::Checked : ECheckBoxState::Unchecked; })
+		.OnCheckStateChanged_Lambda([value](ECheckBoxState state) { *value = state == ECheckBoxState::Checked; });
+}
+
 TArray<AActor*> getSelectedActors() {
 	TArray<AActor*> actorsArray;
 	USelection * selection = GEditor->GetSelectedActors();
@@ -146,65 +477,234 @@ void FCustomRenderModule::PluginButtonClicked()
 		[
 			SNew(SHorizontalBox)
 			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Aperture:"))]
-		+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(SSpinBox<float>).Tag("Aperture").MinValue(0.7f).MaxValue(32.0f).Value(1.8f)]
+		+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.Aperture, 0.7f, 32.0f)]
 		]
 		+ SScrollBox::Slot().Padding(5)
 		[
 			SNew(SHorizontalBox)
 			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Focal length:"))]
-		+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(SSpinBox<float>).Tag("FocalLength").MinValue(0.1f).MaxValue(300.0f).Value(4.0f)]
+		+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.FocalLength, 0.1f, 300.0f)]
 		]
 		+ SScrollBox::Slot().Padding(5)
 		[
 			SNew(SHorizontalBox)
 			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Camera Height:"))]
-		+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(SSpinBox<float>).Tag("CameraHeight").MinValue(-1000.0f).MaxValue(1000.0f).Value(150.0f)]
+		+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.CameraHeight, -1000.0f, 1000.0f)]
 		]
 		+ SScrollBox::Slot().Padding(5)
 		[
 			SNew(SHorizontalBox)
 			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Radius Multiplier:"))]
-			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(SSpinBox<float>).Tag("RadiusMultiplier").MinValue(0).MaxValue(20.0f).Value(3.0f)]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.RadiusMultiplier, 0, 20.0f)]
 		]
 		+ SScrollBox::Slot().Padding(5)
 		[
 			SNew(SHorizontalBox)
 			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Start Angle:"))]
-			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(SSpinBox<float>).Tag("StartAngle").MinValue(-360.0f).MaxValue(720.0f).Value(0.0f)]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.StartAngle, -360.0f, 720.0f)]
 		]
 		+ SScrollBox::Slot().Padding(5)
 		[
 			SNew(SHorizontalBox)
 			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("End Angle:"))]
-			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(SSpinBox<float>).Tag("EndAngle").MinValue(-360.0f).MaxValue(720.0f).Value(180.0f)]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.EndAngle, -360.0f, 720.0f)]
 		]
 		+ SScrollBox::Slot().Padding(5)
 		[
 			SNew(SHorizontalBox)
 			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Lookat Height Adjust:"))]
-			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(SSpinBox<float>).Tag("LookatHeightAdjust").MinValue(-20.0f).MaxValue(20.0f).Value(0.5f)]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.LookatHeightAdjust, -20.0f, 20.0f)]
 		]
 		+ SScrollBox::Slot().Padding(5)
 		[
 			SNew(SHorizontalBox)
 			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("FPS:"))]
-			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(SSpinBox<float>).Tag("FPS").MinValue(1.0f).MaxValue(512.0f).Value(30.0f)]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.FPS, 1.0f, 512.0f)]
 		]
 		+ SScrollBox::Slot().Padding(5)
 		[
 			SNew(SHorizontalBox)
 			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Fix Pivot:"))]
-			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(SCheckBox).Tag("FixPivot")]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalBoolEditor(&Settings.Global.bFixPivot)]
 		]
 		+ SScrollBox::Slot().Padding(5)
 		[
 			SNew(SHorizontalBox)
 			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Center Pivot:"))]
-			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(SCheckBox).Tag("CenterPivot")]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalBoolEditor(&Settings.Global.bCenterPivot)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Incremental Update:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalBoolEditor(&Settings.Global.bIncremental)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Minimal Keys:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalBoolEditor(&Settings.Global.bMinimalKeys)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Max Key Error (cm):"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.MaxKeyError, 0.001f, 10.0f)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Max Angle Error (deg):"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.MaxAngleError, 0.001f, 5.0f)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Bake Look At:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalBoolEditor(&Settings.Global.bBakeLookAt)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Write Camera Manifest:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalBoolEditor(&Settings.Global.bWriteManifest)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Manifest CSV:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalBoolEditor(&Settings.Global.bWriteManifestCsv)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Coverage Planner:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalBoolEditor(&Settings.Global.bCoveragePlanner)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Coverage View Angle:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.CoverageViewAngle, 1.0f, 90.0f)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Target Coverage:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.TargetCoverage, 0.0f, 1.0f)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Min Elevation:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.MinElevation, -90.0f, 90.0f)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Max Elevation:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.MaxElevation, -90.0f, 90.0f)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Adaptive Duration:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalBoolEditor(&Settings.Global.bAdaptiveDuration)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Camera Speed (cm/s):"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.CameraSpeed, 0.0f, 10000.0f)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Angular Speed (deg/s):"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.AngularSpeed, 0.0f, 720.0f)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Min Shot Seconds:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.MinShotSeconds, 0.0f, 60.0f)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Max Shot Seconds:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.MaxShotSeconds, 0.0f, 600.0f)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Cluster Targets:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalBoolEditor(&Settings.Global.bClusterTargets)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Cluster Gap:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.ClusterGap, 0.0f, 1000.0f)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Max Cluster Size:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.MaxClusterSize, 0.0f, 10000.0f)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Shard Size (0 = off):"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalIntEditor(&Settings.Global.ShardSize, 0, 100000)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Shard to Rebuild:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalIntEditor(&ShardToRebuild, 0, 100000)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Check Visibility:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalBoolEditor(&Settings.Global.bCheckVisibility)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Adjust Occluded Orbits:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalBoolEditor(&Settings.Global.bAdjustOccluded)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Visibility Samples:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalIntEditor(&Settings.Global.VisibilitySamples, 2, 256)]
+		]
+		+ SScrollBox::Slot().Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[SNew(STextBlock).Text(FText::FromString("Min Visibility:"))]
+			+ SHorizontalBox::Slot().FillWidth(0.5f)[GlobalFloatEditor(&Settings.Global.MinVisibility, 0.0f, 1.0f)]
 		]
 		+ SScrollBox::Slot().Padding(10)
 		[
 			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().FillWidth(0.5f).HAlign(HAlign_Left).VAlign(VAlign_Center)
+			[
+				SNew(SButton)
+				.Text(FText::FromString("Rebuild Shard..."))
+					.OnClicked_Lambda([this]()
+				{
+					// Only this run is limited to the shard, Create Sequence keeps updating every shard
+					Settings.Global.RebuildShard = ShardToRebuild;
+					this->CreateSequence();
+					Settings.Global.RebuildShard = INDEX_NONE;
+					return FReply::Handled();
+				})
+			]
 			+ SHorizontalBox::Slot().FillWidth(0.5f).HAlign(HAlign_Right).VAlign(VAlign_Center)
 			[
 				SNew(SButton)
@@ -218,334 +718,1144 @@ void FCustomRenderModule::PluginButtonClicked()
 		]
 		];
 
-	ParentBox->AddSlot()
-	[
-		SNew(SScrollBox)
-		+ SScrollBox::Slot().Padding(10)
-		[
-			SNew(SHorizontalBox)
-			+ SHorizontalBox::Slot().FillWidth(1.0f).HAlign(HAlign_Center).VAlign(VAlign_Center)
-			[SNew(STextBlock).Text(FText::FromString("Per Object Settings"))]
-		]
-		[
-			SNew(SHorizontalBox)
-			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f).HAlign(HAlign_Center)[SNew(STextBlock).Text(FText::FromString(" "))]
-			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.4f).HAlign(HAlign_Center)[SNew(STextBlock).Text(FText::FromString("Object"))]
-			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f).HAlign(HAlign_Center)[SNew(STextBlock).Text(FText::FromString("CH"))]
-			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f).HAlign(HAlign_Center)[SNew(STextBlock).Text(FText::FromString("R"))]
-			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f).HAlign(HAlign_Center)[SNew(STextBlock).Text(FText::FromString("LH"))]
-			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f).HAlign(HAlign_Center)[SNew(STextBlock).Text(FText::FromString("SA"))]
-			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f).HAlign(HAlign_Center)[SNew(STextBlock).Text(FText::FromString("EA"))]
-			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f).HAlign(HAlign_Center)[SNew(STextBlock).Text(FText::FromString("FP"))]
-			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f).HAlign(HAlign_Center)[SNew(STextBlock).Text(FText::FromString("CP"))]
-		]
-	];
-
-	for (auto actor : selectedActors)
-	{
-		auto actorLabelString = actor->GetActorLabel();
-		auto actorLabelText = FText::FromString(actorLabelString);
-		
-		auto actorCheck = FString(actorLabelString + "-isEnabled");
-		auto actorCH = FString(actorLabelString + "-CH");
-		auto actorR = FString(actorLabelString + "-R");
-		auto actorLH = FString(actorLabelString + "-LH");
-		auto actorSA = FString(actorLabelString + "-SA");
-		auto actorEA = FString(actorLabelString + "-EA");
-		auto actorFP = FString(actorLabelString + "-FP");
-		auto actorCP = FString(actorLabelString + "-CP");
-		
-		ParentBox->AddSlot()
-		[
-			SNew(SHorizontalBox)
-			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f)[SNew(SCheckBox).Tag(FName(*actorCheck))]
-			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.4f)[SNew(STextBlock).Text(actorLabelText)]
-			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f)[SNew(SSpinBox<float>).Tag(FName(*actorCH)).Value(0).MinValue(-1000).MaxValue(1000)]
-			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f)[SNew(SSpinBox<float>).Tag(FName(*actorR)).Value(1.0f).MinValue(0.0f).MaxValue(20.0f)]
-			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f)[SNew(SSpinBox<float>).Tag(FName(*actorLH)).Value(1.0f).MinValue(-20).MaxValue(20)]
-			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f)[SNew(SSpinBox<float>).Tag(FName(*actorSA)).Value(0.0f).MinValue(-360.0f).MaxValue(720)]
-			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f)[SNew(SSpinBox<float>).Tag(FName(*actorEA)).Value(180.0f).MinValue(-360.0f).MaxValue(720)]
-			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f)[SNew(SCheckBox).Tag(FName(*actorFP))]
-			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f)[SNew(SCheckBox).Tag(FName(*actorCP))]
-		];
-	}
+	// Per object settings only create widgets for the visible rows. Instanced meshes count one target per instance.
+	FCustomRenderTarget::Expand(selectedActors, selectedTargets);
+	Settings.Reset(selectedTargets);
 
 	// Settings window:
 	auto Window = SNew(SWindow)
 		.Title(FText::FromString(TEXT("Custom Render")))
-		.ClientSize(FVector2D(450, 620))
+		.ClientSize(FVector2D(450, 760))
 		.SupportsMaximize(true)
 		.SupportsMinimize(false)
-		.Content()[ParentBox];
+		.Content()
+		[
+			SNew(SVerticalBox)
+			+ SVerticalBox::Slot().FillHeight(0.5f)[ParentBox]
+			+ SVerticalBox::Slot().FillHeight(0.5f)[SNew(SCustomRenderActorList).Settings(&Settings)]
+		];
 
-	auto window = FSlateApplication::Get().AddWindowAsNativeChild(Window, FSlateApplication::Get().GetActiveTopLevelWindow().ToSharedRef(), true);
-	pwindow = &window.Get();
+	FSlateApplication::Get().AddWindowAsNativeChild(Window, FSlateApplication::Get().GetActiveTopLevelWindow().ToSharedRef(), true);
 }
 
-void FCustomRenderModule::CreateSequence()
+ULevelSequence* FCustomRenderModule::GenerateSequence(UWorld* world, const TArray<AActor*>& targets, const FCustomRenderSettings& settings)
 {
-	auto world = GEditor->GetEditorWorldContext().World();
+	return GenerateSequence(world, TArray<FCustomRenderTarget>(targets), settings);
+}
 
-	std::vector<TSharedRef<SWidget>> childwidgets;
-	allChildWidgets(childwidgets, pwindow->GetChildren()->GetChildAt(0));
+ULevelSequence* FCustomRenderModule::GenerateSequence(UWorld* world, const TArray<FCustomRenderTarget>& targets, const FCustomRenderSettings& settings)
+{
+	check(settings.Actors.Num() == targets.Num());
 
-	std::map<std::string, float> settings;
+	// Tagged cameras already in the level are registered before this run spawns any
+	FindOwnedCameras(world);
 
-	for (auto child : childwidgets) 
-	{
-		// Spin boxes:
-		if (child->GetTypeAsString().Equals("SSpinBox<float>")){
-			auto spinbox = (SSpinBox<float>*)(&child.Get());
-			settings[std::string(TCHAR_TO_UTF8(*spinbox->GetTag().ToString()))] = spinbox->GetValue();
-		}
-
-		// Check boxes:
-		if (child->GetTypeAsString().Equals("SCheckBox")){
-			auto checkbox = (SCheckBox*)(&child.Get());
-			settings[std::string(TCHAR_TO_UTF8(*checkbox->GetTag().ToString()))] = checkbox->IsChecked();
-		}
-	}
-
-	// DEBUG:
-	bool isShowLog = false;
-	if (isShowLog) {
-		std::string log;
-		for (auto kv : settings) { log += kv.first + " = " + std::to_string(kv.second) + "\n"; }
-		FMessageDialog::Open(EAppMsgType::Ok, FText::FromString(FString(log.c_str())));
-	}
+	// Undoing or redoing this run invalidates its shot records, there is no editor to watch when the module starts up
+	if (GEditor) {
+		GEditor->RegisterForUndo(this);
+	}
 
 	auto CleanupPreviousSequence = [=]() {
+		CUSTOMRENDER_SCOPE_PHASE(Cleanup);
 
 		TArray<UObject *> objects;
 
 		// Clean up past sequences
+		if (auto MasterSequenceAsset = FindMasterSequence())
 		{
-			// Get sequencer
-			FAssetRegistryModule& AssetRegistryModule = FModuleManager::GetModuleChecked<FAssetRegistryModule>("AssetRegistry");
-			FString AssetPath = "/Game/Cinematics/Sequences";
-			FString AssetName = "Master"; AssetPath /= AssetName; AssetPath += "." + AssetName;
-			FAssetData AssetData = AssetRegistryModule.Get().GetAssetByObjectPath(*AssetPath);
+			objects.Add(MasterSequenceAsset);
+		}
+		for (auto & shard : FindShardSequences())
+		{
+			objects.Add(shard.Value);
+		}
 
-			if (AssetData.IsValid())
-			{
-				auto MasterSequenceAsset = AssetData.GetAsset();
-				IAssetEditorInstance* AssetEditor = FAssetEditorManager::Get().FindEditorForAsset(MasterSequenceAsset, true);
-				FLevelSequenceEditorToolkit* LevelSequenceEditor = (FLevelSequenceEditorToolkit*)AssetEditor;
-				lastTime = LevelSequenceEditor->GetSequencer().Get()->GetGlobalTime().Time;
+		ObjectTools::ForceDeleteObjects(objects, false);
 
-				objects.Add(MasterSequenceAsset);
+		// Every camera of the level goes back to the pool, those of the last shots keep their target
+		TMap<ACineCameraActor*, FCustomRenderTarget> lastTargets;
+		for (auto & record : ShotRecords)
+		{
+			if (record.Camera.IsValid()) {
+				lastTargets.Add(record.Camera.Get(), record.Target);
 			}
 		}
+		ShotRecords.Reset();
 
-		ObjectTools::ForceDeleteObjects(objects, false);
+		TSet<ACineCameraActor*> pooled;
+		for (auto & entry : PooledCameras)
+		{
+			if (entry.Value.IsValid()) {
+				pooled.Add(entry.Value.Get());
+			}
+		}
 
-		// Clean up past cameras
-		for (auto actor : selectedActors)
+		auto & owned = FindOwnedCameras(world);
+		owned.RemoveAll([](const TWeakObjectPtr<ACineCameraActor> & camera) { return !camera.IsValid(); });
+		for (auto & camera : owned)
 		{
-			auto actorLabel = actor->GetActorLabel();
-			auto cameraLabel = actorLabel;
+			if (pooled.Contains(camera.Get())) continue;
 
-			for (TActorIterator<ACineCameraActor> ActorItr(world); ActorItr; ++ActorItr) {
-				if (ActorItr->GetActorLabel().Equals(cameraLabel)){
-					world->DestroyActor(*ActorItr);
-				}
-			}
+			const FCustomRenderTarget* target = lastTargets.Find(camera.Get());
+			ReleaseCamera(camera.Get(), target ? *target : FCustomRenderTarget());
 		}
 
 		return objects.Num() > 0;
 	};
 
-	auto CreateSequence = [=](std::map<std::string,float> & settings) {
-		std::vector<ACineCameraActor*> allcams;
-		std::vector<FVector> origins, boxes;
-		std::vector<std::string> names;
+	// Create a master sequence
+	auto CreateMasterSequence = [=]() {
+		FString MasterSequenceAssetName = TEXT("Master");
+		FString MasterSequencePackagePath = SequencePackagePath;
+
+		return FCustomRenderAssetFactory::CreateAsset<ULevelSequence>(MasterSequenceAssetName, MasterSequencePackagePath);
+	};
+
+	// Look at point relative to the target actor, as the camera's look at tracking expects it
+	auto LookatOffset = [](const FCustomRenderShotSettings & shot, const FVector & origin, const FVector & box) {
+		return FVector(
+			shot.bFixPivot ? origin.X : 0, 
+			shot.bFixPivot ? origin.Y : 0,
+			box.Z * shot.LookatHeightAdjust);
+	};
+
+	auto ConfigureCamera = [&](ACineCameraActor * camera, AActor * actor, const FVector & lookatOffset) {
+		const FCustomRenderGlobalSettings & global = settings.Global;
+
+		// Camera settings
+		auto camSettings = camera->GetCineCameraComponent();
+
+		// Fixed values for: Sony IMX258 sensor
+		camSettings->FilmbackSettings.SensorWidth = SensorWidth;
+		camSettings->FilmbackSettings.SensorHeight = SensorHeight;
+
+		camSettings->LensSettings.MinFocalLength = global.FocalLength;
+		camSettings->LensSettings.MaxFocalLength = global.FocalLength;
+		camSettings->LensSettings.MinFStop = global.Aperture;
+		camSettings->LensSettings.MaxFStop = global.Aperture;
+
+		camSettings->CurrentFocalLength = global.FocalLength;
+		camSettings->CurrentAperture = global.Aperture;
+
+		// Look at property
+		camera->LookatTrackingSettings.ActorToTrack = actor;
+		camera->LookatTrackingSettings.RelativeOffset = lookatOffset;
+
+		// A baked rotation needs no tracking, nor its debug drawing, at runtime
+		camera->LookatTrackingSettings.bEnableLookAtTracking = !global.bBakeLookAt;
+		camera->LookatTrackingSettings.bDrawDebugLookAtTrackingPosition = !global.bBakeLookAt;
+	};
+
+	auto CreateSequence = [&]() -> ULevelSequence* {
+		const FCustomRenderGlobalSettings & global = settings.Global;
+		const int32 numTargets = targets.Num();
+
+		// Generation runs in four stages of one unit each: bounds over the targets, spawn and bind over the
+		// shots and key over the changed shots, plus visibility over the orbits when it is checked. Each stage
+		// splits its units over the items it loops over, and progress is entered in chunks so large selections
+		// don't spend their time redrawing the dialog.
+		const bool checkVisibility = global.bCheckVisibility && !global.bCoveragePlanner;
+		const int32 progressChunk = 64;
+		FScopedSlowTask SlowTask(checkVisibility ? 5.0f : 4.0f, LOCTEXT("GeneratingSequence", "Generating camera sequence..."));
+		SlowTask.MakeDialog(true);
+
+		bool isCancelled = false;
+		auto StepStage = [&](int32 i, int32 count, const FText & stage, float units = 1.0f) {
+			if (i % progressChunk == 0)
+			{
+				SlowTask.EnterProgressFrame(units * float(FMath::Min(progressChunk, count - i)) / float(count), stage);
+				isCancelled = isCancelled || SlowTask.ShouldCancel();
+			}
+			return !isCancelled;
+		};
+
+		std::vector<FVector> origins, boxes, lookatOffsets;
+		std::vector<FCustomRenderShotSettings> shots;
+		std::vector<OrbitCore::OrbitParams> orbits;
+		std::vector<uint32> hashes;
+
+		// Planned views don't depend on the object, they are planned once and scaled to each target
+		std::vector<OrbitCore::Vec3> plannedViews;
+		uint32 plannerHash = 0;
+		if (global.bCoveragePlanner)
+		{
+			OrbitCore::CoverageParams coverage;
+			coverage.MinElevation = global.MinElevation;
+			coverage.MaxElevation = global.MaxElevation;
+			coverage.ViewAngle = global.CoverageViewAngle;
+			coverage.TargetCoverage = global.TargetCoverage;
+			plannedViews = OrbitCore::PlanCoverage(coverage);
+
+			plannerHash = HashCombine(GetTypeHash(global.MinElevation), GetTypeHash(global.MaxElevation));
+			plannerHash = HashCombine(plannerHash, HashCombine(GetTypeHash(global.CoverageViewAngle), GetTypeHash(global.TargetCoverage)));
+		}
+
+		// Instances are measured in bulk, once per component
+		TMap<const UInstancedStaticMeshComponent*, TArray<FCustomRenderBounds>> instanceBounds;
+		auto InstanceBounds = [&](const FCustomRenderTarget & target) {
+			const UInstancedStaticMeshComponent* component = target.Component.Get();
+			TArray<FCustomRenderBounds>* bounds = instanceBounds.Find(component);
+			if (!bounds) {
+				bounds = &instanceBounds.Add(component);
+				FCustomRenderBoundsCache::MeasureInstances(component, *bounds);
+			}
+			return bounds->IsValidIndex(target.Instance) ? (*bounds)[target.Instance] : FCustomRenderBounds();
+		};
 
-		// Generate a camera for each object in the selection
-		for (auto actor : selectedActors)
+		// Bounds: resolve every shot before touching the level or the sequence. Actors are measured here the
+		// first time, behind the progress dialog, and come from the bounds cache on later runs.
 		{
-			auto actorLabel = actor->GetActorLabel();
-
-			// Per object settings
-			bool isCustom = settings[std::string(TCHAR_TO_UTF8(*actorLabel)) + "-isEnabled"] != 0.0f;
-			float MyLookatHeightAdjust = settings[std::string(TCHAR_TO_UTF8(*actorLabel)) + "-LH"];
-			bool isCustomFP = settings[std::string(TCHAR_TO_UTF8(*actorLabel)) + "-FP"] != 0.0f;
-			bool isCustomCP = settings[std::string(TCHAR_TO_UTF8(*actorLabel)) + "-CP"] != 0.0f;
-
-			// Actor properties
-			FVector origin, box, delta(0,0,0);
-			actor->GetActorBounds(false, origin, box);
-
-			// Fix pivot option is selected
-			if (settings["FixPivot"] != 0.0f || isCustomFP) {
-				origin = actor->GetComponentsBoundingBox().GetCenter();
-			}
-			if (settings["CenterPivot"] != 0.0f || isCustomCP) {
-				auto center = actor->GetComponentsBoundingBox().GetCenter();
-				delta = center - origin;
-				origin += delta;
-			}
-
-			// Keep records
-			origins.push_back(origin);
-			boxes.push_back(box);
-			names.push_back(TCHAR_TO_UTF8(*actorLabel));
-
-			// Position camera:
-			FActorSpawnParameters CamSpawnInfo;
-			FRotator CamRotation(0, 0, 0);
-			FVector CamPos = actor->GetActorLocation();
-
-			// Create camera
-			auto camera = world->SpawnActor<ACineCameraActor>(CamPos, CamRotation, CamSpawnInfo);
-			camera->SetActorLabel(actorLabel);
-
-			// Camera settings
-			auto camSettings = camera->GetCineCameraComponent();
-
-			// Fixed values for: Sony IMX258 sensor
-			camSettings->FilmbackSettings.SensorWidth = 4.69469;
-			camSettings->FilmbackSettings.SensorHeight = 3.518753;
-
-			camSettings->LensSettings.MinFocalLength = settings["FocalLength"];
-			camSettings->LensSettings.MaxFocalLength = settings["FocalLength"];
-			camSettings->LensSettings.MinFStop = settings["Aperture"];
-			camSettings->LensSettings.MaxFStop = settings["Aperture"];
-
-			camSettings->CurrentFocalLength = settings["FocalLength"];
-			camSettings->CurrentAperture = settings["Aperture"];
-
-			// Look at property
-			camera->LookatTrackingSettings.ActorToTrack = actor;
-			camera->LookatTrackingSettings.RelativeOffset = FVector(
-				settings["FixPivot"] != 0.0f || isCustomFP ? origin.X : 0, 
-				settings["FixPivot"] != 0.0f || isCustomFP ? origin.Y : 0,
-				box.Z * (isCustom ? MyLookatHeightAdjust * settings["LookatHeightAdjust"] : settings["LookatHeightAdjust"]));
-			camera->LookatTrackingSettings.bEnableLookAtTracking = true;
-			camera->LookatTrackingSettings.bDrawDebugLookAtTrackingPosition = true;
-
-			allcams.push_back(camera);
-		}
-
-		// Create a master sequence
-		auto CreateMasterSequence = [=]() {
-			FString MasterSequenceAssetName = TEXT("Master");
-			FString MasterSequencePackagePath = TEXT("/Game/Cinematics/Sequences");
-
-			auto AssetName = MasterSequenceAssetName;
-			auto PackagePath = MasterSequencePackagePath;
-
-			IAssetTools& AssetTools = FModuleManager::GetModuleChecked<FAssetToolsModule>("AssetTools").Get();
-			UObject* NewAsset = nullptr;
-			for (TObjectIterator<UClass> It; It; ++It) {
-				UClass* CurrentClass = *It;
-				if (CurrentClass->IsChildOf(UFactory::StaticClass()) && !(CurrentClass->HasAnyClassFlags(CLASS_Abstract))) {
-					UFactory* Factory = Cast<UFactory>(CurrentClass->GetDefaultObject());
-					if (Factory->CanCreateNew() && Factory->ImportPriority >= 0 && Factory->SupportedClass == ULevelSequence::StaticClass()) {
-						NewAsset = AssetTools.CreateAsset(AssetName, PackagePath, ULevelSequence::StaticClass(), Factory);
-						break;
+			CUSTOMRENDER_SCOPE_PHASE(Bounds);
+
+			const FText boundsStage = LOCTEXT("BoundsStage", "Measuring objects...");
+			for (int32 i = 0; i < numTargets; i++)
+			{
+				if (!StepStage(i, numTargets, boundsStage)) return nullptr;
+
+				const FCustomRenderTarget & target = targets[i];
+
+				// Per object settings
+				const FCustomRenderShotSettings shot = FCustomRenderShotSettings::Resolve(global, settings.Actors[i]);
+
+				// Actor properties
+				const FCustomRenderBounds bounds = target.IsInstance() ? InstanceBounds(target) : FCustomRenderBoundsCache::Get(target.GetActor());
+				FVector origin = bounds.Origin, box = bounds.Extent, delta(0,0,0);
+
+				// Fix pivot option is selected
+				if (shot.bFixPivot) {
+					origin = bounds.CollisionCenter;
+				}
+				if (shot.bCenterPivot) {
+					auto center = bounds.CollisionCenter;
+					delta = center - origin;
+					origin += delta;
+				}
+
+				// Everything the camera and its keys depend on. Not its slot in the sequence: a shot that only moved in
+				// time keeps its keys and is shifted, so adding or removing a target doesn't re-key every later shot.
+				uint32 hash = HashCombine(GetTypeHash(shot), GetTypeHash(origin));
+				hash = HashCombine(hash, GetTypeHash(box));
+				hash = HashCombine(hash, GetTypeHash(global.FocalLength));
+				hash = HashCombine(hash, GetTypeHash(global.Aperture));
+				hash = HashCombine(hash, GetTypeHash(global.FPS));
+				hash = HashCombine(hash, GetTypeHash(global.bMinimalKeys ? global.MaxKeyError : 0.0f));
+				hash = HashCombine(hash, GetTypeHash(global.bMinimalKeys && global.bBakeLookAt ? global.MaxAngleError : 0.0f));
+				hash = HashCombine(hash, GetTypeHash(global.bBakeLookAt));
+				hash = HashCombine(hash, plannerHash);
+
+				/// Camera flying animation
+				OrbitCore::OrbitParams orbit;
+				orbit.Origin = { origin.X, origin.Y, origin.Z };
+				orbit.Extent = { box.X, box.Y, box.Z };
+				orbit.RadiusMultiplier = shot.RadiusMultiplier;
+				orbit.CameraHeight = shot.CameraHeight;
+				orbit.StartAngle = shot.StartAngle;
+				orbit.EndAngle = shot.EndAngle;
+
+				// Keep records
+				origins.push_back(origin);
+				boxes.push_back(box);
+				lookatOffsets.push_back(LookatOffset(shot, origin, box));
+
+				// Cameras track the owner of an instance, the offset moves from the instance's space to the owner's
+				if (target.IsInstance()) {
+					const FVector lookAt = target.GetTransform().TransformPosition(lookatOffsets.back());
+					lookatOffsets.back() = target.GetActor()->GetActorTransform().InverseTransformPosition(lookAt);
+				}
+				shots.push_back(shot);
+				orbits.push_back(orbit);
+				hashes.push_back(hash);
+			}
+		}
+
+		// Shots: one per target, or one per cluster of nearby targets. Everything below works per shot.
+		TArray<FCustomRenderTarget> shotTargets(targets);
+		std::vector<std::vector<int32>> shotMembers(numTargets);
+		for (int32 i = 0; i < numTargets; i++) shotMembers[i] = { i };
+
+		if (global.bClusterTargets)
+		{
+			CUSTOMRENDER_SCOPE_PHASE(Cluster);
+
+			std::vector<OrbitCore::ClusterBounds> objectBounds(numTargets);
+			for (int32 i = 0; i < numTargets; i++)
+			{
+				objectBounds[i] = { { origins[i].X, origins[i].Y, origins[i].Z }, { boxes[i].X, boxes[i].Y, boxes[i].Z } };
+			}
+
+			OrbitCore::ClusterParams clusterParams;
+			clusterParams.MaxGap = global.ClusterGap;
+			clusterParams.MaxSize = global.MaxClusterSize;
+			const auto clusters = OrbitCore::ClusterObjects(objectBounds, clusterParams);
+
+			// A cluster shot keeps the settings of its first target and orbits the combined bounds
+			shotTargets.Reset(int32(clusters.size()));
+			shotMembers.clear();
+			for (size_t c = 0; c < clusters.size(); c++)
+			{
+				const auto & members = clusters[c];
+				const int32 lead = members[0];
+				const int32 s = int32(shotMembers.size());
+
+				shotTargets.Add(targets[lead]);
+				shotMembers.push_back(std::vector<int32>(members.begin(), members.end()));
+
+				origins[s] = origins[lead];
+				boxes[s] = boxes[lead];
+				shots[s] = shots[lead];
+				orbits[s] = orbits[lead];
+				lookatOffsets[s] = lookatOffsets[lead];
+				uint32 hash = hashes[lead];
+
+				if (members.size() > 1)
+				{
+					OrbitCore::ClusterBounds combined = objectBounds[lead];
+					for (int32 m : members)
+					{
+						combined = OrbitCore::UnionBounds(combined, objectBounds[m]);
+						if (m != lead) hash = HashCombine(hash, hashes[m]);
 					}
+
+					origins[s] = FVector(combined.Center.X, combined.Center.Y, combined.Center.Z);
+					boxes[s] = FVector(combined.Extent.X, combined.Extent.Y, combined.Extent.Z);
+					orbits[s].Origin = combined.Center;
+					orbits[s].Extent = combined.Extent;
+
+					// Same convention as a single target, with the middle of the cluster as its pivot
+					const FVector lookAt = origins[s] + FVector(0, 0, boxes[s].Z * shots[s].LookatHeightAdjust);
+					lookatOffsets[s] = targets[lead].GetActor()->GetActorTransform().InverseTransformPosition(lookAt);
 				}
+				hashes[s] = hash;
 			}
 
-			return NewAsset;
-		};
+			for (auto vec : { &origins, &boxes, &lookatOffsets }) vec->resize(clusters.size());
+			shots.resize(clusters.size());
+			orbits.resize(clusters.size());
+			hashes.resize(clusters.size());
+		}
+		const int32 numShots = shotTargets.Num();
 
-		// Create master sequence
-		UObject* MasterSequenceAsset = CreateMasterSequence();
-		FAssetEditorManager::Get().OpenEditorForAsset(MasterSequenceAsset);
-		IAssetEditorInstance* AssetEditor = FAssetEditorManager::Get().FindEditorForAsset(MasterSequenceAsset, true);
-		FLevelSequenceEditorToolkit* LevelSequenceEditor = (FLevelSequenceEditorToolkit*)AssetEditor;
-		ISequencer* Sequencer = LevelSequenceEditor->GetSequencer().Get();
-		auto seq = Sequencer->GetRootMovieSceneSequence();
+		// Visibility: trace from every orbit to its target, move or trim the occluded ones and report them all
+		std::vector<float> visibility(numShots, 1.0f);
+		if (checkVisibility)
+		{
+			CUSTOMRENDER_SCOPE_PHASE(Visibility);
+
+			OrbitCore::VisibilityParams visParams;
+			visParams.NumPositions = FMath::Max(2, global.VisibilitySamples);
+			visParams.MinVisibility = global.MinVisibility;
+			const int32 raysPerOrbit = OrbitCore::RaysPerOrbit(visParams);
+
+			// The targets every shot covers, resolved once so the traces only compare pointers
+			struct FShotMember
+			{
+				const AActor* Actor;
+				const UPrimitiveComponent* Component;
+				int32 Item;
+			};
+			std::vector<FShotMember> members;
+			std::vector<int32> memberStarts(numShots + 1, 0);
+			for (int32 i = 0; i < numShots; i++)
+			{
+				memberStarts[i] = int32(members.size());
+				for (int32 m : shotMembers[i])
+				{
+					const FCustomRenderTarget & member = targets[m];
+					members.push_back(member.IsInstance()
+						? FShotMember{ nullptr, member.Component.Get(), member.Instance }
+						: FShotMember{ member.GetActor(), nullptr, INDEX_NONE });
+				}
+			}
+			memberStarts[numShots] = int32(members.size());
+
+			// A ray reaches a shot when it hits nothing before its end, or one of the targets the shot covers
+			auto HitsShot = [&](int32 shot, const FHitResult & hit) {
+				const UPrimitiveComponent* component = hit.Component.Get();
+				const AActor* actor = hit.GetActor();
+				for (int32 m = memberStarts[shot]; m < memberStarts[shot + 1]; m++)
+				{
+					const FShotMember & member = members[m];
+					const bool isMember = member.Component
+						? component == member.Component && hit.Item == member.Item
+						: actor == member.Actor;
+					if (isMember) return true;
+				}
+				return false;
+			};
+
+			// The plugin's cameras never block a ray
+			FCollisionQueryParams queryParams(FName(TEXT("CustomRenderVisibility")), false);
+			for (auto & camera : FindOwnedCameras(world))
+			{
+				if (camera.IsValid()) queryParams.AddIgnoredActor(camera.Get());
+			}
+
+			// Trace a batch of orbits, orbitShots holds the shot of every orbit. Scene queries only read the physics
+			// scene, so each chunk of orbits is traced on worker threads while the game thread waits and then steps
+			// the progress, which is where a cancel is noticed. The engine's async traces aren't used since they only
+			// complete on a world tick, which a modal generation run never yields to.
+			const FText visibilityStage = LOCTEXT("VisibilityStage", "Checking visibility...");
+			std::vector<OrbitCore::VisibilityRay> rays(size_t(progressChunk) * raysPerOrbit);
+			std::vector<uint8> visible(rays.size());
+			auto TraceOrbits = [&](const std::vector<OrbitCore::OrbitParams> & batch, const std::vector<int32> & orbitShots, float units, std::vector<std::vector<double>> & outPositions) {
+				const int32 numOrbits = int32(batch.size());
+				outPositions.resize(numOrbits);
+				for (int32 begin = 0; begin < numOrbits; begin += progressChunk)
+				{
+					if (!StepStage(begin, numOrbits, visibilityStage, units)) return false;
+
+					ParallelFor(FMath::Min(progressChunk, numOrbits - begin), [&](int32 c) {
+						const int32 o = begin + c;
+						OrbitCore::VisibilityRay* orbitRays = &rays[size_t(c) * raysPerOrbit];
+						uint8* orbitVisible = &visible[size_t(c) * raysPerOrbit];
+						OrbitCore::WriteVisibilityRays(batch[o], visParams, orbitRays);
+
+						for (int32 r = 0; r < raysPerOrbit; r++)
+						{
+							const FVector start(orbitRays[r].Start.X, orbitRays[r].Start.Y, orbitRays[r].Start.Z);
+							const FVector stop(orbitRays[r].End.X, orbitRays[r].End.Y, orbitRays[r].End.Z);
+							FHitResult hit;
+							const bool blocked = world->LineTraceSingleByChannel(hit, start, stop, ECC_Visibility, queryParams);
+							orbitVisible[r] = !blocked || HitsShot(orbitShots[o], hit);
+						}
+						OrbitCore::PositionVisibility(orbitVisible, visParams, outPositions[o]);
+					});
+				}
+				return true;
+			};
+
+			// The orbits as they are, then their alternatives, half of the stage each
+			const float tracedUnits = global.bAdjustOccluded ? 0.5f : 1.0f;
+			std::vector<int32> orbitShots(numShots);
+			for (int32 i = 0; i < numShots; i++) orbitShots[i] = i;
+			std::vector<std::vector<double>> positions;
+			if (!TraceOrbits(orbits, orbitShots, tracedUnits, positions)) return nullptr;
+
+			std::vector<const TCHAR*> actions(numShots, TEXT("Visible"));
+			std::vector<int32> occluded;
+			for (int32 i = 0; i < numShots; i++)
+			{
+				visibility[i] = float(OrbitCore::MeanVisibility(positions[i]));
+				if (visibility[i] < global.MinVisibility) {
+					occluded.push_back(i);
+					actions[i] = TEXT("Occluded");
+				}
+			}
+			const std::vector<float> traced(visibility);
+
+			if (global.bAdjustOccluded && occluded.size() > 0)
+			{
+				// The alternatives of every occluded orbit, in one batch
+				std::vector<OrbitCore::OrbitParams> candidates;
+				std::vector<int32> candidateShots;
+				for (int32 i : occluded)
+				{
+					const auto alternatives = OrbitCore::CandidateOrbits(orbits[i]);
+					candidates.insert(candidates.end(), alternatives.begin() + 1, alternatives.end());
+					candidateShots.insert(candidateShots.end(), alternatives.size() - 1, i);
+				}
+
+				std::vector<std::vector<double>> candidatePositions;
+				if (!TraceOrbits(candidates, candidateShots, 1.0f - tracedUnits, candidatePositions)) return nullptr;
+
+				// The best alternative that is visible enough, else the visible arc of the orbit, else the best alternative
+				size_t c = 0;
+				for (int32 i : occluded)
+				{
+					int32 best = INDEX_NONE;
+					float bestVisibility = visibility[i];
+					for (; c < candidates.size() && candidateShots[c] == i; c++)
+					{
+						const float candidateVisibility = float(OrbitCore::MeanVisibility(candidatePositions[c]));
+						if (candidateVisibility > bestVisibility) {
+							best = int32(c);
+							bestVisibility = candidateVisibility;
+						}
+					}
+
+					OrbitCore::OrbitParams trimmed;
+					double trimmedVisibility = 0.0;
+					if (best != INDEX_NONE && bestVisibility >= global.MinVisibility) {
+						orbits[i] = candidates[best];
+						visibility[i] = bestVisibility;
+						actions[i] = TEXT("Moved");
+					}
+					else if (OrbitCore::TrimToVisibleArc(orbits[i], positions[i], global.MinVisibility, trimmed, trimmedVisibility)) {
+						orbits[i] = trimmed;
+						visibility[i] = float(trimmedVisibility);
+						actions[i] = TEXT("Trimmed");
+					}
+					else if (best != INDEX_NONE) {
+						orbits[i] = candidates[best];
+						visibility[i] = bestVisibility;
+					}
+
+					// Keys follow the adjusted orbit
+					hashes[i] = HashCombine(hashes[i], HashCombine(GetTypeHash(float(orbits[i].CameraHeight)), GetTypeHash(float(orbits[i].RadiusMultiplier))));
+					hashes[i] = HashCombine(hashes[i], HashCombine(GetTypeHash(float(orbits[i].StartAngle)), GetTypeHash(float(orbits[i].EndAngle))));
+				}
+			}
+
+			int32 numOccluded = 0;
+			for (float shotVisibility : visibility) {
+				numOccluded += shotVisibility < global.MinVisibility ? 1 : 0;
+			}
+			UE_LOG(LogCustomRender, Display, TEXT("Visibility: %d of %d shots under %.2f before adjusting, %d after"), int32(occluded.size()), numShots, global.MinVisibility, numOccluded);
+
+			WriteVisibilityReport(shotTargets, traced, visibility, actions);
+		}
+
+		// Reuse the Master sequence when it still holds what the last run generated
+		ULevelSequence* MasterSequenceAsset = FindMasterSequence();
+		const bool hasRecords = MasterSequenceAsset && MasterSequenceAsset == MasterSequence.Get() && ShotRecords.Num() > 0;
+		bool isIncremental = global.bIncremental && hasRecords;
+
+		// Shards: child sequences of ShardSize consecutive shots, found again by name on later runs
+		const int32 shardSize = global.ShardSize;
+		int32 numShards = shardSize > 0 ? (numShots + shardSize - 1) / shardSize : 0;
+
+		// A single shard is only rebuilt into the layout it was generated with, anything else regenerates everything
+		int32 rebuildShard = global.RebuildShard;
+		if (rebuildShard != INDEX_NONE)
+		{
+			const TMap<int32, ULevelSequence*> existingShards = FindShardSequences();
+			bool sameLayout = MasterSequenceAsset && rebuildShard < numShards && existingShards.Num() == numShards;
+			for (auto & shard : existingShards) {
+				sameLayout = sameLayout && shard.Key < numShards;
+			}
+
+			if (sameLayout) {
+				UE_LOG(LogCustomRender, Display, TEXT("Rebuilding shard %d of %d"), rebuildShard, numShards);
+				isIncremental = true;
+			}
+			else {
+				UE_LOG(LogCustomRender, Warning, TEXT("Master doesn't hold %d shards of %d shots, shard %d can't be rebuilt alone and every shard is generated again"), numShards, shardSize, rebuildShard);
+				rebuildShard = INDEX_NONE;
+			}
+		}
+
+		if (!isIncremental) {
+			CleanupPreviousSequence();
+			MasterSequenceAsset = CreateMasterSequence();
+		}
+		MasterSequence = MasterSequenceAsset;
+
+		auto seq = MasterSequenceAsset;
 		auto scene = seq->GetMovieScene();
 
+		std::vector<ULevelSequence*> shardSequences(numShards);
+		{
+			TArray<UObject*> unusedShards;
+			for (auto & shard : FindShardSequences())
+			{
+				if (shard.Key < numShards) {
+					shardSequences[shard.Key] = shard.Value;
+				}
+				else {
+					unusedShards.Add(shard.Value);
+				}
+			}
+			if (unusedShards.Num() > 0) {
+				ObjectTools::ForceDeleteObjects(unusedShards, false);
+			}
+
+			for (int32 k = 0; k < numShards; k++)
+			{
+				if (!shardSequences[k]) {
+					shardSequences[k] = FCustomRenderAssetFactory::CreateAsset<ULevelSequence>(GetShardName(k), SequencePackagePath);
+				}
+				if (!shardSequences[k]) {
+					UE_LOG(LogCustomRender, Error, TEXT("Can't create the shard sequence %s, every shot goes to Master"), *GetShardName(k));
+					numShards = 0;
+					break;
+				}
+			}
+		}
+
+		// Sequence that holds the camera of a shot
+		auto ShotSequence = [&](int32 i) {
+			return numShards > 0 ? shardSequences[i / shardSize] : seq;
+		};
+		auto ShotShard = [&](int32 i) {
+			return numShards > 0 ? i / shardSize : INDEX_NONE;
+		};
+
+		// Shots this run regenerates, all of them unless a single shard is rebuilt
+		auto IsRebuilt = [&](int32 i) {
+			return rebuildShard == INDEX_NONE || ShotShard(i) == rebuildShard;
+		};
+
+		// Without records of this session the shots are read back from the camera cuts of every shard. Shots are laid
+		// out in order, the n-th cut of shard k is shot k * shardSize + n. Their hashes are unknown, so the next full
+		// run keys them again but keeps their cameras and bindings.
+		if (rebuildShard != INDEX_NONE && !hasRecords)
+		{
+			ShotRecords.Reset();
+			for (int32 k = 0; k < numShards; k++)
+			{
+				UMovieScene* shardScene = shardSequences[k]->GetMovieScene();
+				UMovieSceneTrack* cutTrack = shardScene->GetCameraCutTrack();
+				if (!cutTrack) continue;
+
+				TArray<UMovieSceneSection*> cuts = cutTrack->GetAllSections();
+				cuts.Sort([](const UMovieSceneSection & a, const UMovieSceneSection & b) { return a.GetInclusiveStartFrame() < b.GetInclusiveStartFrame(); });
+				for (int32 n = 0; n < cuts.Num(); n++)
+				{
+					FCustomRenderShotRecord record;
+					record.CutSection = Cast<UMovieSceneCameraCutSection>(cuts[n]);
+					if (!record.CutSection.IsValid()) continue;
+
+					record.CameraGuid = record.CutSection->GetCameraGuid();
+					record.Sequence = shardSequences[k];
+					record.Shard = k;
+
+					TArray<UObject*, TInlineAllocator<1>> bound;
+					shardSequences[k]->LocateBoundObjects(record.CameraGuid, world, bound);
+					record.Camera = bound.Num() > 0 ? Cast<ACineCameraActor>(bound[0]) : nullptr;
+
+					auto moveTrack = shardScene->FindTrack<UMovieScene3DTransformTrack>(record.CameraGuid);
+					if (moveTrack && moveTrack->GetAllSections().Num() > 0) {
+						record.MoveSection = Cast<UMovieScene3DTransformSection>(moveTrack->GetAllSections()[0]);
+					}
+
+					// Cuts past the shard's shots have no target and are removed with the shots no longer selected
+					const int32 i = k * shardSize + n;
+					if (n < shardSize && i < numShots) {
+						record.Target = shotTargets[i];
+					}
+					ShotRecords.Add(record);
+				}
+			}
+		}
+
+		// Everything below is one undo step. Deleting the previous Master or shards isn't undoable, so it happens before.
+		FScopedTransaction Transaction(GenerationTransactionContext, LOCTEXT("GenerateSequenceTransaction", "Generate Camera Sequence"), seq);
+		seq->Modify();
+		scene->Modify();
+		for (int32 k = 0; k < numShards; k++)
+		{
+			if (rebuildShard != INDEX_NONE && k != rebuildShard) continue;
+
+			shardSequences[k]->Modify();
+			shardSequences[k]->GetMovieScene()->Modify();
+		}
+
 		FFrameRate FrameResolution = seq->GetMovieScene()->GetFrameResolution();
 
 		// Create camera cut sections
 		int startTime = FrameResolution.AsFrameNumber(0.0).Value;
 		int deltaTime = FrameResolution.AsFrameNumber(1.0).Value;
 
-	    // One second for each camera
-		scene->SetPlaybackRange(TRange<FFrameNumber>(startTime, int(deltaTime * allcams.size())));
+		// One second for each orbit or as long as the camera speed needs, one frame for each view of a planned shot
+		const int fps = int(global.FPS);
+		const int plannedDuration = FrameResolution.AsFrameNumber(double(plannedViews.size()) / global.FPS).Value;
+		std::vector<int> shotStarts(numShots), durations(numShots), keysPerShot(numShots, fps);
+		int endTime = startTime;
+		std::vector<int> shardEnds(numShards);
+		for (int32 i = 0; i < numShots; i++)
+		{
+			// Each shard has its own timeline, shots don't move when an earlier shard changes length
+			if (numShards > 0 && i % shardSize == 0) {
+				endTime = startTime;
+			}
 
-		// Create camera cut track
-		UMovieSceneCameraCutTrack *CameraCutTrack = (UMovieSceneCameraCutTrack*)scene->AddCameraCutTrack(UMovieSceneCameraCutTrack::StaticClass());
+			if (global.bCoveragePlanner)
+			{
+				durations[i] = plannedDuration;
+			}
+			else if (global.bAdaptiveDuration)
+			{
+				const double seconds = OrbitCore::ShotSeconds(orbits[i], global.CameraSpeed, global.AngularSpeed, global.MinShotSeconds, global.MaxShotSeconds);
+				durations[i] = std::max(1, FrameResolution.AsFrameNumber(seconds).Value);
+				keysPerShot[i] = std::max(2, FMath::RoundToInt(seconds * global.FPS));
+			}
+			else
+			{
+				durations[i] = deltaTime;
+			}
+			shotStarts[i] = endTime;
+			endTime += durations[i];
+			if (numShards > 0) {
+				shardEnds[i / shardSize] = endTime;
+			}
 
-		// Animation key interpolation type
-		EMovieSceneKeyInterpolation KeyInterpolation = EMovieSceneKeyInterpolation::Auto;
-		bool unwind = false;
+			// Keys are spread over the shot, a new start only shifts them
+			hashes[i] = HashCombine(hashes[i], GetTypeHash(durations[i]));
+			hashes[i] = HashCombine(hashes[i], GetTypeHash(keysPerShot[i]));
+		}
 
-		for (size_t i = 0; i < allcams.size(); i++)
+		// Master plays the shards back to back through a subsequence track
+		std::vector<int> shardStarts(numShards);
+		UMovieSceneSubTrack* ShardTrack = scene->FindMasterTrack<UMovieSceneSubTrack>();
+		if (numShards > 0)
 		{
-			bool isCustom = settings[names[i] + "-isEnabled"] != 0.0f;
+			if (!ShardTrack) {
+				ShardTrack = scene->AddMasterTrack<UMovieSceneSubTrack>();
+			}
+			ShardTrack->Modify();
+			ShardTrack->RemoveAllAnimationData();
 
-			auto & camera = allcams[i];
-			auto & box = boxes[i];
-			auto & origin = origins[i];
+			int shardStart = startTime;
+			for (int32 k = 0; k < numShards; k++)
+			{
+				const int shardDuration = shardEnds[k] - startTime;
+				if (rebuildShard == INDEX_NONE || k == rebuildShard) {
+					shardSequences[k]->GetMovieScene()->SetPlaybackRange(TRange<FFrameNumber>(startTime, shardEnds[k]));
+				}
+				ShardTrack->AddSequence(shardSequences[k], shardStart, shardDuration);
+				shardStarts[k] = shardStart;
+				shardStart += shardDuration;
+			}
+			endTime = shardStart;
+		}
+		else if (ShardTrack)
+		{
+			scene->RemoveMasterTrack(*ShardTrack);
+		}
 
-			auto SectionTimeRange = TRange<FFrameNumber>::Inclusive(
-				startTime + ((i == 0) ? -deltaTime : 0 ), 
-				startTime + deltaTime +((i == allcams.size() - 1) ? deltaTime : 0));
+		scene->SetPlaybackRange(TRange<FFrameNumber>(startTime, endTime));
+
+		// Start of a shot in Master time
+		auto MasterStart = [&](int32 i) {
+			return numShards > 0 ? shardStarts[i / shardSize] + shotStarts[i] - startTime : shotStarts[i];
+		};
 
-			// Get camera FGuid
-			FGuid CameraGuid = scene->AddPossessable(camera->GetActorLabel(), camera->GetClass());
-			seq->BindPossessableObject(CameraGuid, *camera, camera->GetWorld());
+		// Camera cut tracks, one per sequence that holds shots
+		TMap<ULevelSequence*, UMovieSceneCameraCutTrack*> cutTracks;
+		auto ShotCutTrack = [&](int32 i) {
+			ULevelSequence* shotSeq = ShotSequence(i);
+			if (auto found = cutTracks.Find(shotSeq)) {
+				return *found;
+			}
 
-			// Create camera cut section
+			UMovieScene* shotScene = shotSeq->GetMovieScene();
+			UMovieSceneCameraCutTrack *CameraCutTrack = (UMovieSceneCameraCutTrack*)shotScene->GetCameraCutTrack();
+			if (!CameraCutTrack) {
+				CameraCutTrack = (UMovieSceneCameraCutTrack*)shotScene->AddCameraCutTrack(UMovieSceneCameraCutTrack::StaticClass());
+			}
 			CameraCutTrack->Modify();
-			auto CamCutNewSection = Cast<UMovieSceneCameraCutSection>(CameraCutTrack->CreateNewSection());
-			CamCutNewSection->SetCameraGuid(CameraGuid);
-			CamCutNewSection->SetRange(SectionTimeRange);
-			CameraCutTrack->AddSection(*CamCutNewSection);
+			return cutTracks.Add(shotSeq, CameraCutTrack);
+		};
+
+		auto RemoveShot = [=](const FCustomRenderShotRecord & record) {
+			if (record.CutSection.IsValid()) {
+				auto cutTrack = CastChecked<UMovieSceneCameraCutTrack>(record.CutSection->GetOuter());
+				cutTrack->Modify();
+				cutTrack->RemoveSection(*record.CutSection.Get());
+			}
+			if (record.CameraGuid.IsValid() && record.Sequence.IsValid()) {
+				record.Sequence->UnbindPossessableObjects(record.CameraGuid);
+				record.Sequence->GetMovieScene()->RemovePossessable(record.CameraGuid);
+			}
+			if (record.Camera.IsValid()) {
+				ReleaseCamera(record.Camera.Get(), record.Target);
+			}
+		};
+
+		// Drop shots whose target is no longer selected, or no longer leads a cluster
+		TMap<FCustomRenderTarget, FCustomRenderShotRecord> previousShots;
+		{
+			TSet<FCustomRenderTarget> selected(shotTargets);
+			for (auto & record : ShotRecords)
+			{
+				if (record.Target.IsValid() && selected.Contains(record.Target)) {
+					previousShots.Add(record.Target, record);
+				}
+				else {
+					RemoveShot(record);
+				}
+			}
+			ShotRecords.Reset();
+		}
 
-			// Create new transform track and section
-			auto CamMoveTrack = Cast<UMovieScene3DTransformTrack>(scene->AddTrack(UMovieScene3DTransformTrack::StaticClass(), CameraGuid));
-			auto CamMoveSection = CastChecked<UMovieScene3DTransformSection>(CamMoveTrack->CreateNewSection());
-			CamMoveTrack->AddSection(*CamMoveSection);
-			CamMoveSection->SetRange(TRange<FFrameNumber>::All());
+		// One record per shot, shots that are still intact are reused as they are
+		std::vector<FCustomRenderShotRecord> records(numShots);
+		std::vector<bool> needsSpawn(numShots);
+
+		auto SetTarget = [&](FCustomRenderShotRecord & record, int32 i) {
+			record.Target = shotTargets[i];
+			record.Shard = ShotShard(i);
+			record.Visibility = visibility[i];
+			record.Members.Reset(int32(shotMembers[i].size()));
+			for (int32 m : shotMembers[i]) {
+				record.Members.Add(targets[m]);
+			}
+		};
 
-			/// Add camera flying animation:
-			double camRadius = std::max(box.X, box.Y) * (isCustom ? settings[names[i] + "-R"] * settings["RadiusMultiplier"] : settings["RadiusMultiplier"]);
-			FVector Zaxis(0, 0, 1.0);
+		// Shots that need new keys, in target order
+		OrbitCore::OrbitBatch orbitBatch;
+		std::vector<int32> dirtyShots;
+		std::vector<int> dirtyKeys;
+		std::vector<OrbitCore::OrbitParams> dirtyOrbits;
+		std::vector<OrbitCore::Vec3> dirtyLookAts;
+		orbitBatch.Reserve(numShots);
 
-			// Fly around range
-			double startAngle = settings["StartAngle"];
-			double endAngle = settings["EndAngle"];
+		for (int32 i = 0; i < numShots; i++)
+		{
+			auto & record = records[i];
+			if (auto previous = previousShots.Find(shotTargets[i])) {
+				record = *previous;
+			}
+			SetTarget(record, i);
 
-			if (isCustom) {
-				startAngle = settings[names[i] + "-SA"];
-				endAngle = settings[names[i] + "-EA"];
+			// Shots of the shards that aren't rebuilt keep everything they have
+			if (!IsRebuilt(i)) continue;
+
+			// A shot that moved to another shard is rebuilt there, every shot of a rebuilt shard from scratch
+			needsSpawn[i] = !(record.Camera.IsValid() && record.CutSection.IsValid() && record.MoveSection.IsValid());
+			needsSpawn[i] = needsSpawn[i] || record.Sequence.Get() != ShotSequence(i) || rebuildShard != INDEX_NONE;
+
+			// Unchanged shots keep their camera settings and keys
+			if (needsSpawn[i] || record.Hash != hashes[i])
+			{
+				orbitBatch.Add(orbits[i]);
+				dirtyOrbits.push_back(orbits[i]);
+				dirtyShots.push_back(i);
+				dirtyKeys.push_back(keysPerShot[i]);
+
+				// Same point the look at tracking would follow, read here since actors belong to the game thread
+				const FVector lookAt = shotTargets[i].GetActor()->GetActorTransform().TransformPosition(lookatOffsets[i]);
+				dirtyLookAts.push_back(OrbitCore::Vec3{ lookAt.X, lookAt.Y, lookAt.Z });
 			}
+		}
 
-			double rangeAngle = endAngle - startAngle;
+		// The orbits only depend on the resolved shots, they are evaluated on worker threads
+		// while the game thread spawns and binds the cameras
+		OrbitCore::OrbitBatchPositions orbitPositions;
+		std::vector<std::vector<OrbitCore::TangentKey>> fittedKeys;
+		std::vector<std::vector<OrbitCore::RotationKey>> fittedRotations;
+		TFuture<void> orbitTask = Async<void>(EAsyncExecution::ThreadPool, [&]() {
+			CUSTOMRENDER_SCOPE_PHASE(OrbitMath);
 
-			int fps = int(settings["FPS"]);
+			if (global.bCoveragePlanner)
+			{
+				// Planned shots are keyed straight from their views
+			}
+			else if (global.bMinimalKeys)
+			{
+				fittedKeys.resize(dirtyOrbits.size());
+				fittedRotations.resize(global.bBakeLookAt ? dirtyOrbits.size() : 0);
+				ParallelFor(int32(dirtyOrbits.size()), [&](int32 d) {
+					if (global.bBakeLookAt) {
+						// Keys are also added where the rotation would drift, the position bound alone misses close look at points
+						OrbitCore::FitOrbitKeys(dirtyOrbits[d], global.MaxKeyError, dirtyLookAts[d], global.MaxAngleError, fittedKeys[d], fittedRotations[d]);
+					}
+					else {
+						OrbitCore::FitOrbitKeys(dirtyOrbits[d], global.MaxKeyError, fittedKeys[d]);
+					}
+				});
+			}
+			else
+			{
+				orbitPositions.Resize(dirtyKeys);
+
+				const int32 batchSize = 64;
+				const int32 numBatches = (int32(orbitBatch.Num()) + batchSize - 1) / batchSize;
+				ParallelFor(numBatches, [&](int32 batch) {
+					size_t begin = size_t(batch) * batchSize;
+					size_t end = std::min(begin + batchSize, orbitBatch.Num());
+					OrbitCore::EvaluateBatch(orbitBatch, begin, end, orbitPositions);
+				});
+			}
+		});
+
+		// Spawn: cameras for new shots and shots that lost part of their objects
+		{
+			CUSTOMRENDER_SCOPE_PHASE(Spawn);
 
-			for (int time = 0; time < fps; time++)
+			const FText spawnStage = LOCTEXT("SpawnStage", "Spawning cameras...");
+			for (int32 i = 0; i < numShots && StepStage(i, numShots, spawnStage); i++)
 			{
-				double t = double(time) / double(fps-1);
-				double theta = startAngle + (t * rangeAngle);
+				if (!needsSpawn[i]) continue;
 
-				FVector pos = FVector(origin.X, origin.Y, 0) 
-					+ FVector(0, 0, (isCustom ? settings[names[i] + "-CH"] + settings["CameraHeight"] : settings["CameraHeight"])) 
-					+ FVector(camRadius, 0, 0).RotateAngleAxis(theta, Zaxis);
+				const FCustomRenderTarget & target = shotTargets[i];
+				auto & record = records[i];
 
-				FFrameNumber KeyTime = startTime + int(t * deltaTime);
+				// Whatever is left of a broken shot is rebuilt from scratch
+				RemoveShot(record);
+				record = FCustomRenderShotRecord();
+				SetTarget(record, i);
 
-				auto FloatChannels = CamMoveSection->GetChannelProxy().GetChannels<FMovieSceneFloatChannel>();
-				FloatChannels[0]->AddCubicKey(KeyTime, pos.X);
-				FloatChannels[1]->AddCubicKey(KeyTime, pos.Y);
-				FloatChannels[2]->AddCubicKey(KeyTime, pos.Z);
-				
-				// Set initial camera position for better preview
-				if (time == 0) camera->SetActorLocation(pos);
+				record.Camera = AcquireCamera(world, target);
 			}
 
-			startTime += deltaTime;
+			// Every shot has its camera now, the pool would only grow from one run to the next
+			if (!isCancelled) {
+				TrimCameraPool(world);
+			}
 		}
 
-		// Update viewport
+		// Bind: possessables, camera cuts and transform tracks
 		{
+			CUSTOMRENDER_SCOPE_PHASE(Bind);
+
+			const FText bindStage = LOCTEXT("BindStage", "Binding cameras...");
+			for (int32 i = 0; i < numShots && StepStage(i, numShots, bindStage); i++)
+			{
+				if (!IsRebuilt(i)) continue;
+
+				auto & record = records[i];
+
+				if (needsSpawn[i])
+				{
+					auto camera = record.Camera.Get();
+					auto shotSeq = ShotSequence(i);
+					auto shotScene = shotSeq->GetMovieScene();
+					auto CameraCutTrack = ShotCutTrack(i);
+
+					// Get camera FGuid
+					FGuid CameraGuid = shotScene->AddPossessable(camera->GetActorLabel(), camera->GetClass());
+					shotSeq->BindPossessableObject(CameraGuid, *camera, camera->GetWorld());
+					record.CameraGuid = CameraGuid;
+					record.Sequence = shotSeq;
+
+					// Create camera cut section
+					auto CamCutNewSection = Cast<UMovieSceneCameraCutSection>(CameraCutTrack->CreateNewSection());
+					CamCutNewSection->SetCameraGuid(CameraGuid);
+					CameraCutTrack->AddSection(*CamCutNewSection);
+					record.CutSection = CamCutNewSection;
+
+					// Create new transform track and section
+					auto CamMoveTrack = Cast<UMovieScene3DTransformTrack>(shotScene->AddTrack(UMovieScene3DTransformTrack::StaticClass(), CameraGuid));
+					auto CamMoveSection = CastChecked<UMovieScene3DTransformSection>(CamMoveTrack->CreateNewSection());
+					CamMoveTrack->AddSection(*CamMoveSection);
+					CamMoveSection->SetRange(TRange<FFrameNumber>::All());
+					record.MoveSection = CamMoveSection;
+				}
+
+				// Camera cut ranges depend on the neighbours, they are always laid out again.
+				// The first and last shot of every sequence reach past its ends.
+				const int shotStart = shotStarts[i];
+				const bool isFirst = numShards > 0 ? i % shardSize == 0 : i == 0;
+				const bool isLast = i == numShots - 1 || (numShards > 0 && i % shardSize == shardSize - 1);
+				auto SectionTimeRange = TRange<FFrameNumber>::Inclusive(
+					shotStart + (isFirst ? -deltaTime : 0 ), 
+					shotStart + durations[i] + (isLast ? deltaTime : 0));
+				if (record.CutSection->GetRange() != SectionTimeRange) {
+					record.CutSection->SetRange(SectionTimeRange);
+				}
+
+				// Intact keys of a shot that only moved in time are shifted along, changed shots are keyed below
+				if (!needsSpawn[i] && record.Hash == hashes[i] && record.StartFrame != shotStart) {
+					record.MoveSection->MoveSection(FFrameNumber(shotStart - record.StartFrame));
+					record.StartFrame = shotStart;
+				}
+			}
+		}
+
+		// Key: camera settings and keys of the changed shots, once the orbit math is done
+		{
+			CUSTOMRENDER_SCOPE_PHASE(Key);
+
+			orbitTask.Wait();
+
+			FTransformKeyWriter keys;
+			const FText keyStage = LOCTEXT("KeyStage", "Keying cameras...");
+			for (int32 d = 0; d < int32(dirtyShots.size()) && StepStage(d, int32(dirtyShots.size()), keyStage); d++)
+			{
+				const int32 i = dirtyShots[d];
+				auto & record = records[i];
+				const int shotStart = shotStarts[i];
+				const int duration = durations[i];
+
+				ConfigureCamera(record.Camera.Get(), shotTargets[i].GetActor(), lookatOffsets[i]);
+
+				if (global.bCoveragePlanner)
+				{
+					// One key on each rendered frame
+					keys.Reserve(plannedViews.size());
+					for (size_t view = 0; view < plannedViews.size(); view++)
+					{
+						const OrbitCore::Vec3 position = OrbitCore::PlannedViewPosition(orbits[i], plannedViews[view]);
+						FVector pos(position.X, position.Y, position.Z);
+						keys.Add(shotStart + FrameResolution.AsFrameNumber(double(view) / global.FPS).Value, pos);
+
+						// Set initial camera position for better preview
+						if (view == 0) record.Camera->SetActorLocation(pos);
+					}
+				}
+				else if (global.bMinimalKeys)
+				{
+					const auto & fitted = fittedKeys[d];
+
+					// Each key lands on the frame KeyFrame rounds it to, keys that round onto the previous one are dropped
+					std::vector<size_t> kept;
+					std::vector<int> frames;
+					for (size_t k = 0; k < fitted.size(); k++)
+					{
+						const int frame = OrbitCore::KeyFrame(fitted[k].T, shotStart, duration);
+						if (frames.empty() || frame > frames.back()) {
+							kept.push_back(k);
+							frames.push_back(frame);
+						}
+					}
+
+					// Tangents are per normalized shot time, keys expect them per frame. The scale of a segment comes
+					// from the frames its keys actually landed on, in double, so uneven rounding doesn't bend the curve.
+					auto SegmentScale = [&](size_t j) {
+						return (fitted[kept[j + 1]].T - fitted[kept[j]].T) / double(frames[j + 1] - frames[j]);
+					};
+					auto ScaleTangent = [](const OrbitCore::Vec3 & tangent, double scale) {
+						return FVector(tangent.X * scale, tangent.Y * scale, tangent.Z * scale);
+					};
+
+					keys.Reserve(kept.size());
+					for (size_t j = 0; j < kept.size(); j++)
+					{
+						const double arriveScale = j > 0 ? SegmentScale(j - 1) : (kept.size() > 1 ? SegmentScale(0) : 1.0 / double(duration));
+						const double leaveScale = j + 1 < kept.size() ? SegmentScale(j) : arriveScale;
+
+						const auto & key = fitted[kept[j]];
+						keys.Add(frames[j], FVector(key.Position.X, key.Position.Y, key.Position.Z),
+							ScaleTangent(key.Tangent, arriveScale), ScaleTangent(key.Tangent, leaveScale));
+
+						// The fitted rotation replaces the baked one, its tangents are what keeps it within MaxAngleError
+						if (global.bBakeLookAt)
+						{
+							const auto & rotation = fittedRotations[d][kept[j]];
+							keys.AddRotation(FRotator(rotation.Pitch, rotation.Yaw, 0.0f),
+								FRotator(rotation.PitchTangent * arriveScale, rotation.YawTangent * arriveScale, 0.0f),
+								FRotator(rotation.PitchTangent * leaveScale, rotation.YawTangent * leaveScale, 0.0f));
+						}
+					}
+
+					// Set initial camera position for better preview
+					const auto & first = fittedKeys[d][0].Position;
+					record.Camera->SetActorLocation(FVector(first.X, first.Y, first.Z));
+				}
+				else
+				{
+					const size_t offset = orbitPositions.Offset(d);
+					const int numKeys = orbitPositions.NumKeysOf(d);
+
+					keys.Reserve(numKeys);
+					for (int time = 0; time < numKeys; time++)
+					{
+						FVector pos(orbitPositions.X[offset + time], orbitPositions.Y[offset + time], orbitPositions.Z[offset + time]);
+						keys.Add(OrbitCore::KeyFrame(OrbitCore::KeyTime(time, numKeys), shotStart, duration), pos);
+
+						// Set initial camera position for better preview
+						if (time == 0) record.Camera->SetActorLocation(pos);
+					}
+				}
+
+				if (global.bBakeLookAt)
+				{
+					// Same point the look at tracking would follow
+					const FVector lookAt = shotTargets[i].GetActor()->GetActorTransform().TransformPosition(lookatOffsets[i]);
+					if (!global.bMinimalKeys || global.bCoveragePlanner) {
+						keys.BakeLookAt(lookAt);
+					}
+					record.Camera->SetActorRotation((lookAt - record.Camera->GetActorLocation()).Rotation());
+				}
+
+				record.MoveSection->Modify();
+				FCustomRenderProfiler::AddKeys(keys.Times.Num());
+				keys.Write(record.MoveSection.Get());
+
+				// Only keyed shots count as up to date
+				record.Hash = hashes[i];
+				record.StartFrame = shotStart;
+			}
+		}
+
+		// The level is marked dirty once instead of by every label
+		world->MarkPackageDirty();
+
+		// A cancelled run keeps everything it created, the next incremental run completes it
+		for (auto & record : records)
+		{
+			if (record.Camera.IsValid() || record.CameraGuid.IsValid()) {
+				ShotRecords.Add(record);
+			}
+		}
+
+		if ((global.bClusterTargets || numShards > 0) && !isCancelled)
+		{
+			CUSTOMRENDER_SCOPE_PHASE(Manifest);
+			WriteShotTargets(ShotRecords);
+		}
+
+		// Poses of every shot for dataset pipelines, computed from the orbits rather than read back from the keys
+		if (global.bWriteManifest && !isCancelled)
+		{
+			CUSTOMRENDER_SCOPE_PHASE(Manifest);
+
+			// Records and CSV rows name the target by its index in the selection, a cluster by its first member.
+			// The binary carries these names as its target table, the CSV repeats them per row.
+			std::vector<std::string> names(numTargets);
+			for (int32 t = 0; t < numTargets; t++)
+			{
+				names[t] = TCHAR_TO_UTF8(*targets[t].GetLabel());
+			}
+
+			std::vector<OrbitCore::ManifestCamera> cameras(numShots);
+			for (int32 i = 0; i < numShots; i++)
+			{
+				const FVector lookAt = shotTargets[i].GetActor()->GetActorTransform().TransformPosition(lookatOffsets[i]);
+
+				auto & camera = cameras[i];
+				camera.Target = uint32(shotMembers[i][0]);
+				camera.FirstFrame = int32(FMath::RoundToInt(double(MasterStart(i) - startTime) / deltaTime * global.FPS));
+				camera.NumFrames = FMath::RoundToInt(double(durations[i]) / deltaTime * global.FPS);
+				camera.Orbit = orbits[i];
+				for (const auto & view : plannedViews)
+				{
+					camera.Path.push_back(OrbitCore::PlannedViewPosition(orbits[i], view));
+				}
+				camera.LookAt = { lookAt.X, lookAt.Y, lookAt.Z };
+				camera.FocalLength = global.FocalLength;
+				camera.Aperture = global.Aperture;
+				camera.SensorWidth = SensorWidth;
+				camera.SensorHeight = SensorHeight;
+			}
+
+			WriteCameraManifest(cameras, names, global.FPS, global.bWriteManifestCsv);
+		}
+
+		return MasterSequenceAsset;
+	};
+
+	// Runs started from the settings window are already profiled, including the viewport update
+	const bool bProfiled = FCustomRenderProfiler::Begin(targets.Num());
+	ULevelSequence* Result = CreateSequence();
+	if (bProfiled) {
+		FCustomRenderProfiler::End();
+	}
+	return Result;
+}
+
+void FCustomRenderModule::CreateSequence()
+{
+	auto world = GEditor->GetEditorWorldContext().World();
+
+	// Keep the play head where it was
+	if (ISequencer* Sequencer = FindMasterSequencer(FindMasterSequence())) {
+		lastTime = Sequencer->GetGlobalTime().Time;
+	}
+
+	FCustomRenderProfiler::Begin(selectedTargets.Num());
+	ULevelSequence* MasterSequenceAsset = GenerateSequence(world, selectedTargets, Settings);
+	if (!MasterSequenceAsset) {
+		FCustomRenderProfiler::End();
+		return;
+	}
+
+	{
+		CUSTOMRENDER_SCOPE_PHASE(Viewport);
+
+		// Open the sequence, an already open editor is reused
+		FAssetEditorManager::Get().OpenEditorForAsset(MasterSequenceAsset);
+		ISequencer* Sequencer = FindMasterSequencer(MasterSequenceAsset);
+		if (!Sequencer)
+		{
+			UE_LOG(LogCustomRender, Warning, TEXT("The sequence was generated but its editor couldn't be opened"));
+		}
+		else
+		{
+			// Update viewport
+			Sequencer->NotifyMovieSceneDataChanged(EMovieSceneDataChangeType::MovieSceneStructureItemsChanged);
+
 			for (int32 i = 0; i < GEditor->LevelViewportClients.Num(); ++i){
 				FLevelEditorViewportClient* LevelVC = GEditor->LevelViewportClients[i];
 				if (LevelVC && LevelVC->IsPerspective() && LevelVC->AllowsCinematicPreview() && LevelVC->GetViewMode() != VMI_Unknown){
@@ -555,15 +1865,16 @@ void FCustomRenderModule::CreateSequence()
 					LevelVC->Invalidate();
 				}
 			}
-			Sequencer->SetViewRange(TRange<double>(-0.25, allcams.size() + 0.25), EViewRangeInterpolation::Immediate);
+			UMovieScene* scene = MasterSequenceAsset->GetMovieScene();
+			const double sequenceSeconds = scene->GetFrameResolution().AsSeconds(scene->GetPlaybackRange().GetUpperBoundValue());
+			Sequencer->SetViewRange(TRange<double>(-0.25, sequenceSeconds + 0.25), EViewRangeInterpolation::Immediate);
 			Sequencer->SetPerspectiveViewportCameraCutEnabled(true);
 			Sequencer->ForceEvaluate();
 			Sequencer->SetGlobalTime(lastTime);
 		}
-	};
+	}
 
-	CleanupPreviousSequence();
-	CreateSequence( settings );
+	FCustomRenderProfiler::End();
 
 	//FMessageDialog::Open(EAppMsgType::Ok, FText::FromString("All done"));
 }
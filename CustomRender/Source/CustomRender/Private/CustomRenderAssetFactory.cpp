@@ -0,0 +1,76 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CustomRenderAssetFactory.h"
+#include "CustomRenderProfiler.h"
+#include "UObject/UObjectIterator.h"
+#include "Factories/Factory.h"
+#include <Developer/AssetTools/Public/IAssetTools.h>
+#include <Developer/AssetTools/Public/AssetToolsModule.h>
+
+TMap<UClass*, TWeakObjectPtr<UFactory>> FCustomRenderAssetFactory::Factories;
+FDelegateHandle FCustomRenderAssetFactory::ModulesChangedHandle;
+
+void FCustomRenderAssetFactory::Initialize()
+{
+	if (!ModulesChangedHandle.IsValid())
+	{
+		ModulesChangedHandle = FModuleManager::Get().OnModulesChanged().AddStatic(&FCustomRenderAssetFactory::OnModulesChanged);
+	}
+}
+
+void FCustomRenderAssetFactory::Shutdown()
+{
+	FModuleManager::Get().OnModulesChanged().Remove(ModulesChangedHandle);
+	ModulesChangedHandle.Reset();
+	Factories.Reset();
+}
+
+void FCustomRenderAssetFactory::OnModulesChanged(FName ModuleName, EModuleChangeReason Reason)
+{
+	// Factory classes come and go with their modules
+	if (Reason == EModuleChangeReason::ModuleLoaded || Reason == EModuleChangeReason::ModuleUnloaded)
+	{
+		Factories.Reset();
+	}
+}
+
+UFactory* FCustomRenderAssetFactory::FindFactory(UClass* AssetClass)
+{
+	if (TWeakObjectPtr<UFactory>* Cached = Factories.Find(AssetClass))
+	{
+		if (Cached->IsValid())
+		{
+			return Cached->Get();
+		}
+	}
+
+	CUSTOMRENDER_SCOPE_PHASE(FactoryScan);
+
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* CurrentClass = *It;
+		if (CurrentClass->IsChildOf(UFactory::StaticClass()) && !(CurrentClass->HasAnyClassFlags(CLASS_Abstract)))
+		{
+			UFactory* Factory = Cast<UFactory>(CurrentClass->GetDefaultObject());
+			if (Factory->CanCreateNew() && Factory->ImportPriority >= 0 && Factory->SupportedClass == AssetClass)
+			{
+				Factories.Add(AssetClass, Factory);
+				return Factory;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+UObject* FCustomRenderAssetFactory::CreateAsset(UClass* AssetClass, const FString& AssetName, const FString& PackagePath)
+{
+	UFactory* Factory = FindFactory(AssetClass);
+	if (!Factory)
+	{
+		return nullptr;
+	}
+
+	IAssetTools& AssetTools = FModuleManager::GetModuleChecked<FAssetToolsModule>("AssetTools").Get();
+	return AssetTools.CreateAsset(AssetName, PackagePath, AssetClass, Factory);
+}
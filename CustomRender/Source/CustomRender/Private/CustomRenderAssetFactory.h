@@ -0,0 +1,41 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ModuleManager.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UFactory;
+
+/** Creates assets through the factory registered for their class, factories are looked up once and cached. */
+class FCustomRenderAssetFactory
+{
+public:
+
+	static void Initialize();
+
+	static void Shutdown();
+
+	/** @return The factory able to create new assets of AssetClass, or nullptr */
+	static UFactory* FindFactory(UClass* AssetClass);
+
+	/** Create a new asset of the given class, nullptr when no factory supports it */
+	static UObject* CreateAsset(UClass* AssetClass, const FString& AssetName, const FString& PackagePath);
+
+	template<typename AssetType>
+	static AssetType* CreateAsset(const FString& AssetName, const FString& PackagePath)
+	{
+		return Cast<AssetType>(CreateAsset(AssetType::StaticClass(), AssetName, PackagePath));
+	}
+
+private:
+
+	static void OnModulesChanged(FName ModuleName, EModuleChangeReason Reason);
+
+private:
+
+	static TMap<UClass*, TWeakObjectPtr<UFactory>> Factories;
+
+	static FDelegateHandle ModulesChangedHandle;
+};
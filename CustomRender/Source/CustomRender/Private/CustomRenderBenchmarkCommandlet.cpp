@@ -0,0 +1,280 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CustomRenderBenchmarkCommandlet.h"
+#include "CustomRender.h"
+#include "CustomRenderSettings.h"
+#include "CustomRenderProfiler.h"
+#include "OrbitCore/OrbitBenchmark.h"
+
+#include "FileHelpers.h"
+#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformMemory.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCustomRenderBenchmark, Log, All);
+
+namespace
+{
+	/** One benchmark measurement, Details holds name=value pairs separated by semicolons */
+	struct FBenchmarkRow
+	{
+		FString Mode;
+		int32 Targets;
+		int32 FPS;
+		double TotalMs;
+		FString Details;
+
+		FString Key() const { return FString::Printf(TEXT("%s,%d,%d"), *Mode, Targets, FPS); }
+	};
+
+	TArray<int32> ParseIntList(const FString& Text)
+	{
+		TArray<FString> Items;
+		Text.ParseIntoArray(Items, TEXT(","));
+
+		TArray<int32> Values;
+		for (const FString& Item : Items)
+		{
+			Values.Add(FCString::Atoi(*Item));
+		}
+		return Values;
+	}
+
+	double UsedPhysicalMB()
+	{
+		return FPlatformMemory::GetStats().UsedPhysical / (1024.0 * 1024.0);
+	}
+
+	/** Totals of a results file by mode, size and FPS */
+	bool LoadBaseline(const FString& Path, TMap<FString, double>& Totals)
+	{
+		TArray<FString> Lines;
+		if (!FFileHelper::LoadFileToStringArray(Lines, *Path))
+		{
+			UE_LOG(LogCustomRenderBenchmark, Error, TEXT("Can't read baseline file %s"), *Path);
+			return false;
+		}
+
+		for (int32 l = 1; l < Lines.Num(); l++)
+		{
+			TArray<FString> Cells;
+			Lines[l].ParseIntoArray(Cells, TEXT(","), false);
+			if (Cells.Num() < 4) continue;
+
+			Totals.Add(Cells[0] + TEXT(",") + Cells[1] + TEXT(",") + Cells[2], FCString::Atod(*Cells[3]));
+		}
+		return true;
+	}
+
+	/** Blank map with NumActors cubes on a square grid, the layout of OrbitCore::MakeSyntheticOrbits */
+	UWorld* CreateSyntheticLevel(int32 NumActors, TArray<AActor*>& OutActors)
+	{
+		UWorld* World = UEditorLoadingAndSavingUtils::NewBlankMap(false);
+		UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+		if (!World || !Cube)
+		{
+			return nullptr;
+		}
+
+		const float Spacing = 300.0f;
+		const int32 Side = FMath::Max(1, FMath::CeilToInt(FMath::Sqrt(float(NumActors))));
+
+		OutActors.Reset(NumActors);
+		for (int32 i = 0; i < NumActors; i++)
+		{
+			const FVector Location((i % Side) * Spacing, (i / Side) * Spacing, 50.0f);
+			AStaticMeshActor* Actor = World->SpawnActor<AStaticMeshActor>(Location, FRotator::ZeroRotator);
+			Actor->GetStaticMeshComponent()->SetStaticMesh(Cube);
+			OutActors.Add(Actor);
+		}
+		return World;
+	}
+}
+
+UCustomRenderBenchmarkCommandlet::UCustomRenderBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UCustomRenderBenchmarkCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	const FString* SizesParam = ParamVals.Find(TEXT("Sizes"));
+	const FString* FPSParam = ParamVals.Find(TEXT("FPS"));
+	const FString* ToleranceParam = ParamVals.Find(TEXT("Tolerance"));
+	const TArray<int32> Sizes = ParseIntList(SizesParam ? *SizesParam : TEXT("10,100,1000,10000,100000"));
+	const TArray<int32> FPSList = ParseIntList(FPSParam ? *FPSParam : TEXT("30,60"));
+	const double Tolerance = ToleranceParam ? FCString::Atod(**ToleranceParam) : 0.25;
+	const bool bMathOnly = Switches.Contains(TEXT("MathOnly"));
+	const bool bUpdateBaseline = Switches.Contains(TEXT("UpdateBaseline"));
+
+	TMap<FString, double> Baseline;
+	const FString* BaselinePath = ParamVals.Find(TEXT("Baseline"));
+	if (BaselinePath && !LoadBaseline(*BaselinePath, Baseline) && !bUpdateBaseline) return 1;
+
+	TArray<FBenchmarkRow> Rows;
+	const float MaxKeyError = FCustomRenderGlobalSettings().MaxKeyError;
+
+	// OrbitCore alone, single threaded
+	for (int32 Size : Sizes)
+	{
+		for (int32 FPS : FPSList)
+		{
+			const OrbitCore::BenchmarkResult Result = OrbitCore::RunBenchmark(Size, FPS, MaxKeyError);
+
+			FBenchmarkRow Row;
+			Row.Mode = TEXT("Math");
+			Row.Targets = Size;
+			Row.FPS = FPS;
+			Row.TotalMs = Result.BatchSeconds * 1000.0;
+			Row.Details = FString::Printf(TEXT("ReferenceMs=%.3f;BatchMs=%.3f;MinimalMs=%.3f;MinimalKeys=%llu"),
+				Result.ReferenceSeconds * 1000.0, Result.BatchSeconds * 1000.0, Result.MinimalSeconds * 1000.0, uint64(Result.MinimalKeys));
+			Rows.Add(Row);
+
+			UE_LOG(LogCustomRenderBenchmark, Display, TEXT("Math %d targets at %d FPS: %s"), Size, FPS, *Row.Details);
+		}
+	}
+
+	// Full generation on synthetic levels
+	if (!bMathOnly)
+	{
+		FCustomRenderModule& Module = FModuleManager::LoadModuleChecked<FCustomRenderModule>("CustomRender");
+
+		for (int32 Size : Sizes)
+		{
+			const double LevelStart = FPlatformTime::Seconds();
+			TArray<AActor*> Targets;
+			UWorld* World = CreateSyntheticLevel(Size, Targets);
+			if (!World)
+			{
+				UE_LOG(LogCustomRenderBenchmark, Error, TEXT("Can't create a synthetic level of %d actors"), Size);
+				return 1;
+			}
+			const double LevelMs = (FPlatformTime::Seconds() - LevelStart) * 1000.0;
+
+			for (int32 FPS : FPSList)
+			{
+				// Every row spawns all of its cameras, none are left in the pool from the row before
+				Module.DestroyCameras(World);
+
+				FCustomRenderSettings Settings;
+				Settings.Global.FPS = float(FPS);
+				Settings.Global.bIncremental = false;
+				Settings.Reset(Targets);
+
+				const double MemoryBefore = UsedPhysicalMB();
+				if (!Module.GenerateSequence(World, Targets, Settings))
+				{
+					UE_LOG(LogCustomRenderBenchmark, Error, TEXT("Generation of %d targets failed"), Size);
+					return 1;
+				}
+				const double MemoryAfter = UsedPhysicalMB();
+
+				const FCustomRenderProfile& Profile = FCustomRenderProfiler::GetLastRun();
+
+				FBenchmarkRow Row;
+				Row.Mode = TEXT("Generate");
+				Row.Targets = Size;
+				Row.FPS = FPS;
+				Row.TotalMs = Profile.TotalSeconds * 1000.0;
+				Row.Details = FString::Printf(TEXT("LevelMs=%.3f"), LevelMs);
+				for (int32 p = 0; p < (int32)ECustomRenderPhase::Num; p++)
+				{
+					Row.Details += FString::Printf(TEXT(";%sMs=%.3f"), FCustomRenderProfiler::GetPhaseName(ECustomRenderPhase(p)), Profile.PhaseSeconds[p] * 1000.0);
+				}
+				Row.Details += FString::Printf(TEXT(";Keys=%lld;CamerasSpawned=%d;CamerasReused=%d;MemoryBeforeMB=%.1f;MemoryAfterMB=%.1f;PeakUsedMB=%.1f"),
+					Profile.KeysWritten, Profile.CamerasSpawned, Profile.CamerasReused, MemoryBefore, MemoryAfter, Profile.PeakUsedMB);
+
+				// Peak memory of each phase that ran, as growth over the start of the run
+				for (int32 p = 0; p < (int32)ECustomRenderPhase::Num; p++)
+				{
+					if (Profile.PhasePeakUsedMB[p] > 0.0) {
+						Row.Details += FString::Printf(TEXT(";%sPeakMB=%+.1f"), FCustomRenderProfiler::GetPhaseName(ECustomRenderPhase(p)), Profile.PhasePeakUsedMB[p] - Profile.StartUsedMB);
+					}
+				}
+				Rows.Add(Row);
+
+				UE_LOG(LogCustomRenderBenchmark, Display, TEXT("Generate %d targets at %d FPS: %.1f ms"), Size, FPS, Row.TotalMs);
+			}
+
+			// Drop the level before building the next one
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		}
+	}
+
+	// Results, compared with the baseline when there is one
+	const FString CsvHeader = TEXT("Mode,Targets,FPS,TotalMs,Details") LINE_TERMINATOR;
+	FString Csv = CsvHeader;
+	TArray<FString> MissingRows;
+	int32 NumRegressions = 0;
+	for (const FBenchmarkRow& Row : Rows)
+	{
+		const FString Line = FString::Printf(TEXT("%s,%.3f,%s"), *Row.Key(), Row.TotalMs, *Row.Details) + LINE_TERMINATOR;
+		Csv += Line;
+
+		// A row the baseline doesn't have would never be checked, it fails the run until it is recorded
+		if (BaselinePath && !Baseline.Contains(Row.Key()))
+		{
+			MissingRows.Add(Line);
+			UE_LOG(LogCustomRenderBenchmark, Warning, TEXT("%s: %.1f ms, not in the baseline"), *Row.Key(), Row.TotalMs);
+		}
+		else if (const double* BaselineMs = Baseline.Find(Row.Key()))
+		{
+			const double Ratio = *BaselineMs > 0.0 ? Row.TotalMs / *BaselineMs : 1.0;
+			const bool bRegressed = Ratio > 1.0 + Tolerance;
+			NumRegressions += bRegressed ? 1 : 0;
+
+			UE_LOG(LogCustomRenderBenchmark, Display, TEXT("%s: %.1f ms, baseline %.1f ms (x%.2f)%s"),
+				*Row.Key(), Row.TotalMs, *BaselineMs, Ratio, bRegressed ? TEXT(" REGRESSION") : TEXT(""));
+		}
+	}
+
+	const FString ResultsPath = FPaths::ProjectSavedDir() / TEXT("CustomRender") / TEXT("Benchmark.csv");
+	if (!FFileHelper::SaveStringToFile(Csv, *ResultsPath))
+	{
+		UE_LOG(LogCustomRenderBenchmark, Error, TEXT("Can't write %s"), *ResultsPath);
+		return 1;
+	}
+	UE_LOG(LogCustomRenderBenchmark, Display, TEXT("Results written to %s"), *ResultsPath);
+
+	if (MissingRows.Num() > 0 && bUpdateBaseline)
+	{
+		// Rows already in the baseline keep their values, it is only ever extended
+		FString Appended = IFileManager::Get().FileExists(**BaselinePath) ? FString() : CsvHeader;
+		for (const FString& Line : MissingRows)
+		{
+			Appended += Line;
+		}
+		if (!FFileHelper::SaveStringToFile(Appended, **BaselinePath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append))
+		{
+			UE_LOG(LogCustomRenderBenchmark, Error, TEXT("Can't write %s"), **BaselinePath);
+			return 1;
+		}
+		UE_LOG(LogCustomRenderBenchmark, Display, TEXT("%d rows added to the baseline %s"), MissingRows.Num(), **BaselinePath);
+	}
+	else if (MissingRows.Num() > 0)
+	{
+		UE_LOG(LogCustomRenderBenchmark, Error, TEXT("%d results have no baseline, record them with -UpdateBaseline"), MissingRows.Num());
+		return 1;
+	}
+
+	if (NumRegressions > 0)
+	{
+		UE_LOG(LogCustomRenderBenchmark, Error, TEXT("%d results are slower than the baseline by more than %.0f%%"), NumRegressions, Tolerance * 100.0);
+		return 1;
+	}
+
+	return 0;
+}
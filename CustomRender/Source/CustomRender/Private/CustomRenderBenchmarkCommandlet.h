@@ -0,0 +1,40 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "CustomRenderBenchmarkCommandlet.generated.h"
+
+/**
+ * Times sequence generation on synthetic levels of growing size:
+ *
+ * UE4Editor-Cmd Project.uproject -run=CustomRenderBenchmark -nullrhi
+ *     [-Sizes=10,100,1000,10000,100000] [-FPS=30,60] [-MathOnly]
+ *     [-Baseline=Benchmark.csv] [-Tolerance=0.25] [-UpdateBaseline]
+ *
+ * Each size gets a new blank map with that many cube static mesh actors on a grid. Every FPS
+ * setting then runs a full, non incremental generation of all of them, starting without any camera
+ * so each row spawns the same cameras. The phase times come from the profiler, memory is the used
+ * physical memory before and after the run, its peak, and the peak of each phase over the start.
+ * -MathOnly only times OrbitCore. OrbitCoreBench --sweep of the standalone OrbitCore build writes
+ * the same Math rows without Unreal, Tests/OrbitCore/BenchmarkBaseline.csv is their baseline.
+ *
+ * Results are written to Saved/CustomRender/Benchmark.csv. A run with -Baseline compares each
+ * total with the row of the same mode, size and FPS in the baseline file, and fails when one is
+ * slower than the baseline by more than the tolerance, or missing from it. -UpdateBaseline appends
+ * the missing rows to the baseline file instead, existing rows are never overwritten. Generate rows
+ * depend on the machine, they are recorded on the machine that checks them.
+ */
+UCLASS()
+class UCustomRenderBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UCustomRenderBenchmarkCommandlet();
+
+	// UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+};
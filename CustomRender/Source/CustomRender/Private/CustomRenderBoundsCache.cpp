@@ -0,0 +1,146 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CustomRenderBoundsCache.h"
+#include "GameFramework/Actor.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/Engine.h"
+#include "Editor.h"
+
+TMap<TWeakObjectPtr<AActor>, FCustomRenderBoundsCache::FEntry> FCustomRenderBoundsCache::Entries;
+FDelegateHandle FCustomRenderBoundsCache::ActorMovedHandle;
+FDelegateHandle FCustomRenderBoundsCache::ActorDeletedHandle;
+FDelegateHandle FCustomRenderBoundsCache::PropertyChangedHandle;
+FDelegateHandle FCustomRenderBoundsCache::UndoRedoHandle;
+
+void FCustomRenderBoundsCache::Initialize()
+{
+	if (!PropertyChangedHandle.IsValid())
+	{
+		PropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddStatic(&FCustomRenderBoundsCache::OnObjectPropertyChanged);
+		UndoRedoHandle = FEditorDelegates::PostUndoRedo.AddStatic(&FCustomRenderBoundsCache::Reset);
+	}
+}
+
+void FCustomRenderBoundsCache::Shutdown()
+{
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(PropertyChangedHandle);
+	FEditorDelegates::PostUndoRedo.Remove(UndoRedoHandle);
+	PropertyChangedHandle.Reset();
+	UndoRedoHandle.Reset();
+
+	if (GEngine)
+	{
+		GEngine->OnActorMoved().Remove(ActorMovedHandle);
+		GEngine->OnLevelActorDeleted().Remove(ActorDeletedHandle);
+	}
+	ActorMovedHandle.Reset();
+	ActorDeletedHandle.Reset();
+
+	Entries.Reset();
+}
+
+void FCustomRenderBoundsCache::BindEngineDelegates()
+{
+	// The engine doesn't exist yet when the module starts up
+	if (GEngine && !ActorMovedHandle.IsValid())
+	{
+		ActorMovedHandle = GEngine->OnActorMoved().AddStatic(&FCustomRenderBoundsCache::Invalidate);
+		ActorDeletedHandle = GEngine->OnLevelActorDeleted().AddStatic(&FCustomRenderBoundsCache::Invalidate);
+	}
+}
+
+void FCustomRenderBoundsCache::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& Event)
+{
+	if (AActor* Actor = Cast<AActor>(Object))
+	{
+		Invalidate(Actor);
+	}
+	else if (UActorComponent* Component = Cast<UActorComponent>(Object))
+	{
+		Invalidate(Component->GetOwner());
+	}
+}
+
+void FCustomRenderBoundsCache::Invalidate(AActor* Actor)
+{
+	if (Actor)
+	{
+		Entries.Remove(Actor);
+	}
+}
+
+void FCustomRenderBoundsCache::Reset()
+{
+	Entries.Reset();
+}
+
+FCustomRenderBounds FCustomRenderBoundsCache::Measure(AActor* Actor)
+{
+	FBox AllBox(ForceInit);
+	FBox CollisionBox(ForceInit);
+
+	for (const UActorComponent* ActorComponent : Actor->GetComponents())
+	{
+		const UPrimitiveComponent* PrimComp = Cast<const UPrimitiveComponent>(ActorComponent);
+		if (PrimComp && PrimComp->IsRegistered())
+		{
+			const FBox Box = PrimComp->Bounds.GetBox();
+			AllBox += Box;
+			if (PrimComp->IsCollisionEnabled())
+			{
+				CollisionBox += Box;
+			}
+		}
+	}
+
+	FCustomRenderBounds Bounds;
+	AllBox.GetCenterAndExtents(Bounds.Origin, Bounds.Extent);
+	Bounds.CollisionCenter = CollisionBox.GetCenter();
+	return Bounds;
+}
+
+FCustomRenderBounds FCustomRenderBoundsCache::Get(AActor* Actor)
+{
+	BindEngineDelegates();
+
+	FEntry* Entry = Entries.Find(Actor);
+
+	// Moves that didn't go through the editor don't notify, the transform catches those
+	const FTransform Transform = Actor->GetActorTransform();
+	const int32 NumComponents = Actor->GetComponents().Num();
+	if (!Entry || !Entry->Transform.Equals(Transform, 0.0f) || Entry->NumComponents != NumComponents)
+	{
+		Entry = &Entries.Add(Actor);
+		Entry->Bounds = Measure(Actor);
+		Entry->Transform = Transform;
+		Entry->NumComponents = NumComponents;
+	}
+
+	return Entry->Bounds;
+}
+
+void FCustomRenderBoundsCache::MeasureInstances(const UInstancedStaticMeshComponent* Component, TArray<FCustomRenderBounds>& OutBounds)
+{
+	OutBounds.Reset();
+	if (!Component || !Component->GetStaticMesh())
+	{
+		return;
+	}
+
+	// Instances share the mesh, only its box is transformed per instance
+	const FBox MeshBox = Component->GetStaticMesh()->GetBoundingBox();
+	const FMatrix ComponentToWorld = Component->GetComponentTransform().ToMatrixWithScale();
+	const bool bCollides = Component->IsCollisionEnabled();
+
+	OutBounds.SetNum(Component->PerInstanceSMData.Num());
+	for (int32 i = 0; i < OutBounds.Num(); i++)
+	{
+		const FBox Box = MeshBox.TransformBy(Component->PerInstanceSMData[i].Transform * ComponentToWorld);
+
+		FCustomRenderBounds& Bounds = OutBounds[i];
+		Box.GetCenterAndExtents(Bounds.Origin, Bounds.Extent);
+		Bounds.CollisionCenter = bCollides ? Bounds.Origin : FVector::ZeroVector;
+	}
+}
@@ -0,0 +1,73 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AActor;
+class UObject;
+class UInstancedStaticMeshComponent;
+struct FPropertyChangedEvent;
+
+/** Both boxes a shot is placed from, measured in one pass over the actor's components. */
+struct FCustomRenderBounds
+{
+	/** Center and extent of all registered primitive components, as GetActorBounds(false) */
+	FVector Origin = FVector::ZeroVector;
+	FVector Extent = FVector::ZeroVector;
+
+	/** Center of the colliding components, as GetComponentsBoundingBox() */
+	FVector CollisionCenter = FVector::ZeroVector;
+};
+
+/**
+ * Bounds of the actors the plugin works on, shared by the settings window and generation.
+ * An entry is dropped when its actor moves or one of its components changes, and is checked
+ * against the actor transform and component count before use.
+ */
+class FCustomRenderBoundsCache
+{
+public:
+
+	static void Initialize();
+
+	static void Shutdown();
+
+	/** @return The cached bounds of Actor, measured again when out of date */
+	static FCustomRenderBounds Get(AActor* Actor);
+
+	static void Invalidate(AActor* Actor);
+
+	/**
+	 * Bounds of every instance of Component in one pass over its instance data, in instance order.
+	 * Instances aren't cached: a box transform each is cheaper than keeping a cache in sync.
+	 */
+	static void MeasureInstances(const UInstancedStaticMeshComponent* Component, TArray<FCustomRenderBounds>& OutBounds);
+
+	static void Reset();
+
+private:
+
+	static FCustomRenderBounds Measure(AActor* Actor);
+
+	static void BindEngineDelegates();
+
+	static void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& Event);
+
+private:
+
+	struct FEntry
+	{
+		FCustomRenderBounds Bounds;
+		FTransform Transform;
+		int32 NumComponents;
+	};
+
+	static TMap<TWeakObjectPtr<AActor>, FEntry> Entries;
+
+	static FDelegateHandle ActorMovedHandle;
+	static FDelegateHandle ActorDeletedHandle;
+	static FDelegateHandle PropertyChangedHandle;
+	static FDelegateHandle UndoRedoHandle;
+};
@@ -0,0 +1,273 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CustomRenderGenerateCommandlet.h"
+#include "CustomRender.h"
+#include "CustomRenderSettings.h"
+
+#include "EngineUtils.h"
+#include "FileHelpers.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include <Runtime/LevelSequence/Public/LevelSequence.h>
+
+DEFINE_LOG_CATEGORY_STATIC(LogCustomRenderGenerate, Log, All);
+
+namespace
+{
+	/** Everything read from the config file and the command line */
+	struct FGenerateConfig
+	{
+		FString Map;
+		FString Class;
+		FString Tag;
+		FString Name;
+		FString ActorSettings;
+
+		TMap<FString, float> Global;
+		TMap<FString, TMap<FString, float>> Actors;
+	};
+
+	/** Numbers and booleans become settings values, anything else is logged and skipped */
+	bool JsonToFloat(const FString& Owner, const FString& Key, const TSharedPtr<FJsonValue>& Value, float& Out)
+	{
+		double Number = 0.0;
+		bool bValue = false;
+		if (Value.IsValid() && Value->TryGetNumber(Number))
+		{
+			Out = float(Number);
+			return true;
+		}
+		if (Value.IsValid() && Value->TryGetBool(bValue))
+		{
+			Out = bValue ? 1.0f : 0.0f;
+			return true;
+		}
+		UE_LOG(LogCustomRenderGenerate, Warning, TEXT("Skipping %s.%s, expected a number or a boolean"), *Owner, *Key);
+		return false;
+	}
+
+	bool LoadJsonConfig(const FString& Path, FGenerateConfig& Config)
+	{
+		FString Text;
+		if (!FFileHelper::LoadFileToString(Text, *Path))
+		{
+			UE_LOG(LogCustomRenderGenerate, Error, TEXT("Can't read config file %s"), *Path);
+			return false;
+		}
+
+		TSharedPtr<FJsonObject> Root;
+		if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Text), Root) || !Root.IsValid())
+		{
+			UE_LOG(LogCustomRenderGenerate, Error, TEXT("Invalid JSON in config file %s"), *Path);
+			return false;
+		}
+
+		Root->TryGetStringField(TEXT("Map"), Config.Map);
+		Root->TryGetStringField(TEXT("Class"), Config.Class);
+		Root->TryGetStringField(TEXT("Tag"), Config.Tag);
+		Root->TryGetStringField(TEXT("Name"), Config.Name);
+		if (Root->TryGetStringField(TEXT("ActorSettings"), Config.ActorSettings) && FPaths::IsRelative(Config.ActorSettings))
+		{
+			Config.ActorSettings = FPaths::GetPath(Path) / Config.ActorSettings;
+		}
+
+		const TSharedPtr<FJsonObject>* Global;
+		if (Root->TryGetObjectField(TEXT("Global"), Global))
+		{
+			for (const auto& Value : (*Global)->Values)
+			{
+				float Number;
+				if (JsonToFloat(TEXT("Global"), Value.Key, Value.Value, Number)) Config.Global.Add(Value.Key, Number);
+			}
+		}
+
+		const TSharedPtr<FJsonObject>* Actors;
+		if (Root->TryGetObjectField(TEXT("Actors"), Actors))
+		{
+			for (const auto& Actor : (*Actors)->Values)
+			{
+				const TSharedPtr<FJsonObject>* Settings;
+				if (!Actor.Value.IsValid() || !Actor.Value->TryGetObject(Settings) || !Settings->IsValid())
+				{
+					UE_LOG(LogCustomRenderGenerate, Warning, TEXT("Skipping actor %s in %s, its settings must be an object"), *Actor.Key, *Path);
+					continue;
+				}
+
+				auto& Fields = Config.Actors.FindOrAdd(Actor.Key);
+				for (const auto& Value : (*Settings)->Values)
+				{
+					float Number;
+					if (JsonToFloat(Actor.Key, Value.Key, Value.Value, Number)) Fields.Add(Value.Key, Number);
+				}
+			}
+		}
+
+		return true;
+	}
+
+	bool LoadCsvActorSettings(const FString& Path, FGenerateConfig& Config)
+	{
+		TArray<FString> Lines;
+		if (!FFileHelper::LoadFileToStringArray(Lines, *Path) || Lines.Num() == 0)
+		{
+			UE_LOG(LogCustomRenderGenerate, Error, TEXT("Can't read actor settings file %s"), *Path);
+			return false;
+		}
+
+		TArray<FString> Columns;
+		Lines[0].ParseIntoArray(Columns, TEXT(","), false);
+
+		for (int32 Row = 1; Row < Lines.Num(); Row++)
+		{
+			TArray<FString> Cells;
+			Lines[Row].ParseIntoArray(Cells, TEXT(","), false);
+			if (Cells.Num() == 0 || Cells[0].TrimStartAndEnd().IsEmpty()) continue;
+
+			auto& Fields = Config.Actors.FindOrAdd(Cells[0].TrimStartAndEnd());
+			for (int32 c = 1; c < Cells.Num() && c < Columns.Num(); c++)
+			{
+				if (!Cells[c].TrimStartAndEnd().IsEmpty())
+				{
+					Fields.Add(Columns[c].TrimStartAndEnd(), FCString::Atof(*Cells[c]));
+				}
+			}
+		}
+
+		return true;
+	}
+}
+
+UCustomRenderGenerateCommandlet::UCustomRenderGenerateCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UCustomRenderGenerateCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	// Config file first, the command line overrides it
+	FGenerateConfig Config;
+	if (const FString* ConfigPath = ParamVals.Find(TEXT("Config")))
+	{
+		if (!LoadJsonConfig(*ConfigPath, Config)) return 1;
+	}
+
+	auto Override = [&](const TCHAR* Key, FString& Value) {
+		if (const FString* CommandLineValue = ParamVals.Find(Key)) Value = *CommandLineValue;
+	};
+	Override(TEXT("Map"), Config.Map);
+	Override(TEXT("Class"), Config.Class);
+	Override(TEXT("Tag"), Config.Tag);
+	Override(TEXT("Name"), Config.Name);
+	Override(TEXT("ActorSettings"), Config.ActorSettings);
+
+	if (!Config.ActorSettings.IsEmpty() && !LoadCsvActorSettings(Config.ActorSettings, Config)) return 1;
+
+	if (Config.Map.IsEmpty())
+	{
+		UE_LOG(LogCustomRenderGenerate, Error, TEXT("No map given, use -Map= or \"Map\" in the config file"));
+		return 1;
+	}
+	if (Config.Class.IsEmpty() && Config.Tag.IsEmpty() && Config.Name.IsEmpty())
+	{
+		UE_LOG(LogCustomRenderGenerate, Error, TEXT("No actor filter given, use Class, Tag and/or Name"));
+		return 1;
+	}
+
+	UWorld* World = UEditorLoadingAndSavingUtils::LoadMap(Config.Map);
+	if (!World)
+	{
+		UE_LOG(LogCustomRenderGenerate, Error, TEXT("Can't load map %s"), *Config.Map);
+		return 1;
+	}
+
+	UClass* FilterClass = nullptr;
+	if (!Config.Class.IsEmpty())
+	{
+		FilterClass = FindObject<UClass>(ANY_PACKAGE, *Config.Class);
+		if (!FilterClass || !FilterClass->IsChildOf(AActor::StaticClass()))
+		{
+			UE_LOG(LogCustomRenderGenerate, Error, TEXT("Unknown actor class %s"), *Config.Class);
+			return 1;
+		}
+	}
+
+	// Select the targets, generated cameras are never targets
+	const FName FilterTag = Config.Tag.IsEmpty() ? NAME_None : FName(*Config.Tag);
+	TArray<AActor*> Targets;
+	for (TActorIterator<AActor> ActorItr(World); ActorItr; ++ActorItr)
+	{
+		AActor* Actor = *ActorItr;
+		if (Actor->ActorHasTag(FCustomRenderModule::CameraTag)) continue;
+		if (FilterClass && !Actor->IsA(FilterClass)) continue;
+		if (FilterTag != NAME_None && !Actor->ActorHasTag(FilterTag)) continue;
+		if (!Config.Name.IsEmpty() && !Actor->GetActorLabel().MatchesWildcard(Config.Name) && !Actor->GetName().MatchesWildcard(Config.Name)) continue;
+
+		Targets.Add(Actor);
+	}
+
+	if (Targets.Num() == 0)
+	{
+		UE_LOG(LogCustomRenderGenerate, Warning, TEXT("No actor in %s matches the filters, nothing to generate"), *Config.Map);
+		return 0;
+	}
+
+	// Instanced meshes like foliage get one shot per instance, as in the editor
+	TArray<FCustomRenderTarget> RenderTargets;
+	FCustomRenderTarget::Expand(Targets, RenderTargets);
+
+	// Settings, per object values are matched by target label
+	FCustomRenderSettings Settings;
+	for (const auto& Value : Config.Global)
+	{
+		Settings.SetValue(FName(*Value.Key), Value.Value);
+	}
+	if (const FString* RebuildShard = ParamVals.Find(TEXT("RebuildShard")))
+	{
+		Settings.SetValue(TEXT("RebuildShard"), FCString::Atof(**RebuildShard));
+	}
+
+	Settings.Reset(RenderTargets);
+	for (int32 i = 0; i < RenderTargets.Num(); i++)
+	{
+		if (const auto* Fields = Config.Actors.Find(RenderTargets[i].GetLabel()))
+		{
+			for (const auto& Value : *Fields)
+			{
+				Settings.SetValue(FCustomRenderSettings::MakeActorKey(*Value.Key, i), Value.Value);
+			}
+		}
+	}
+
+	UE_LOG(LogCustomRenderGenerate, Display, TEXT("Generating %d shots for %s"), RenderTargets.Num(), *Config.Map);
+
+	FCustomRenderModule& Module = FModuleManager::LoadModuleChecked<FCustomRenderModule>("CustomRender");
+	ULevelSequence* MasterSequence = Module.GenerateSequence(World, RenderTargets, Settings);
+	if (!MasterSequence)
+	{
+		UE_LOG(LogCustomRenderGenerate, Error, TEXT("Can't create the Master sequence"));
+		return 1;
+	}
+
+	// The sequences bind to cameras spawned in the level, both have to be saved. Shards are
+	// separate assets, every sequence the run changed is saved along with Master.
+	bool bSaved = UEditorLoadingAndSavingUtils::SaveMap(World, Config.Map);
+	bSaved &= UEditorLoadingAndSavingUtils::SaveDirtyPackages(false, true);
+	if (!bSaved)
+	{
+		UE_LOG(LogCustomRenderGenerate, Error, TEXT("Failed to save %s or the sequences"), *Config.Map);
+		return 1;
+	}
+
+	return 0;
+}
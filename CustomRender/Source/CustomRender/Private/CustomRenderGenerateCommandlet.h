@@ -0,0 +1,44 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "CustomRenderGenerateCommandlet.generated.h"
+
+/**
+ * Generates the Master orbit sequence of a map without any UI, e.g. on a build machine:
+ *
+ * UE4Editor-Cmd Project.uproject -run=CustomRenderGenerate -Config=Orbits.json -nullrhi
+ *
+ * The JSON config holds the map, the actor filters and the settings:
+ *
+ * {
+ *     "Map": "/Game/Maps/Kitchen",
+ *     "Class": "StaticMeshActor", "Tag": "Render", "Name": "SM_*",
+ *     "Global": { "FPS": 30, "RadiusMultiplier": 3.0, "FixPivot": true },
+ *     "Actors": { "SM_Chair": { "isEnabled": true, "R": 1.5 } },
+ *     "ActorSettings": "Kitchen.csv"
+ * }
+ *
+ * Global keys are the names of the global settings in the editor window, per object keys are the
+ * column names of the per object settings (isEnabled, CH, R, LH, SA, EA, FP, CP). The optional CSV
+ * file has an Actor column followed by any of those columns, one row per actor label. Actors made only of
+ * instanced static meshes, like foliage, get one shot per instance, labelled Actor_Component_Index.
+ * -Map, -Class, -Tag, -Name and -ActorSettings on the command line override the config file.
+ *
+ * -RebuildShard=N regenerates only shard N of a sharded Master, e.g. on the render node that takes that shard,
+ * and saves the sequences it changed. The other shards are left as they are.
+ */
+UCLASS()
+class UCustomRenderGenerateCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UCustomRenderGenerateCommandlet();
+
+	// UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+};
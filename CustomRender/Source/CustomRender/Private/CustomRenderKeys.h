@@ -0,0 +1,132 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/FrameNumber.h"
+#include "Channels/MovieSceneFloatChannel.h"
+#include "Channels/MovieSceneChannelProxy.h"
+#include "Sections/MovieScene3DTransformSection.h"
+
+/**
+ * Collects the location keys of one transform section up front and writes them
+ * to the X/Y/Z channels in one pass. Tangents are resolved once per channel
+ * instead of after every inserted key.
+ */
+struct FTransformKeyWriter
+{
+	TArray<FFrameNumber> Times;
+	TArray<FMovieSceneFloatValue> Values[3];
+
+	/** Roll, pitch and yaw of every key, empty unless BakeLookAt or AddRotation was called */
+	TArray<FMovieSceneFloatValue> Rotation[3];
+
+	void Reserve(int32 NumKeys)
+	{
+		Times.Reset(NumKeys);
+		for (auto & Channel : Values) Channel.Reset(NumKeys);
+		for (auto & Channel : Rotation) Channel.Reset();
+	}
+
+	/** Keys must be added in increasing time order, a key at the same time as the previous one is dropped and false returned. */
+	bool Add(FFrameNumber Time, const FVector & Position)
+	{
+		if (Times.Num() > 0 && Times.Last() >= Time) return false;
+
+		Times.Add(Time);
+		for (int32 c = 0; c < 3; c++)
+		{
+			FMovieSceneFloatValue & Key = Values[c][Values[c].AddDefaulted()];
+			Key.Value = Position[c];
+			Key.InterpMode = RCIM_Cubic;
+			Key.TangentMode = RCTM_Auto;
+		}
+		return true;
+	}
+
+	/** Add a key with explicit tangents, in value per frame of the section's tick resolution, they differ when the keys around it are not evenly spaced. */
+	bool Add(FFrameNumber Time, const FVector & Position, const FVector & ArriveTangent, const FVector & LeaveTangent)
+	{
+		if (Times.Num() > 0 && Times.Last() >= Time) return false;
+
+		Times.Add(Time);
+		for (int32 c = 0; c < 3; c++)
+		{
+			FMovieSceneFloatValue & Key = Values[c][Values[c].AddDefaulted()];
+			Key.Value = Position[c];
+			Key.InterpMode = RCIM_Cubic;
+			Key.TangentMode = RCTM_User;
+			Key.Tangent.ArriveTangent = ArriveTangent[c];
+			Key.Tangent.LeaveTangent = LeaveTangent[c];
+		}
+		return true;
+	}
+
+	/** Rotation of the last added key with explicit tangents per frame, every key needs one before Write. */
+	void AddRotation(const FRotator & Rotator, const FRotator & ArriveTangent, const FRotator & LeaveTangent)
+	{
+		const float Angles[3] = { Rotator.Roll, Rotator.Pitch, Rotator.Yaw };
+		const float Arrive[3] = { ArriveTangent.Roll, ArriveTangent.Pitch, ArriveTangent.Yaw };
+		const float Leave[3] = { LeaveTangent.Roll, LeaveTangent.Pitch, LeaveTangent.Yaw };
+		for (int32 c = 0; c < 3; c++)
+		{
+			FMovieSceneFloatValue & Key = Rotation[c][Rotation[c].AddDefaulted()];
+			Key.Value = Angles[c];
+			Key.InterpMode = RCIM_Cubic;
+			Key.TangentMode = RCTM_User;
+			Key.Tangent.ArriveTangent = Arrive[c];
+			Key.Tangent.LeaveTangent = Leave[c];
+		}
+	}
+
+	/** Aim every collected key at Target. Yaw is unwound so consecutive keys never turn the long way round. */
+	void BakeLookAt(const FVector & Target)
+	{
+		for (auto & Channel : Rotation) Channel.Reset(Times.Num());
+
+		float PreviousYaw = 0.0f;
+		for (int32 k = 0; k < Times.Num(); k++)
+		{
+			const FVector Position(Values[0][k].Value, Values[1][k].Value, Values[2][k].Value);
+			FRotator Rotator = (Target - Position).Rotation();
+			if (k > 0) Rotator.Yaw = PreviousYaw + FRotator::NormalizeAxis(Rotator.Yaw - PreviousYaw);
+			PreviousYaw = Rotator.Yaw;
+
+			const float Angles[3] = { Rotator.Roll, Rotator.Pitch, Rotator.Yaw };
+			for (int32 c = 0; c < 3; c++)
+			{
+				FMovieSceneFloatValue & Key = Rotation[c][Rotation[c].AddDefaulted()];
+				Key.Value = Angles[c];
+				Key.InterpMode = RCIM_Cubic;
+				Key.TangentMode = RCTM_Auto;
+			}
+		}
+	}
+
+	/** Replace the location keys of the section with the collected ones, and its rotation keys with the baked ones or none. */
+	void Write(UMovieScene3DTransformSection * Section)
+	{
+		TArrayView<FMovieSceneFloatChannel*> FloatChannels = Section->GetChannelProxy().GetChannels<FMovieSceneFloatChannel>();
+		for (int32 c = 0; c < 3; c++)
+		{
+			FloatChannels[c]->Set(Times, MoveTemp(Values[c]));
+			FloatChannels[c]->AutoSetTangents();
+		}
+
+		const bool bHasRotation = Rotation[0].Num() > 0 && Rotation[0].Num() == Times.Num();
+		for (int32 c = 0; c < 3; c++)
+		{
+			if (bHasRotation)
+			{
+				FloatChannels[3 + c]->Set(Times, MoveTemp(Rotation[c]));
+				FloatChannels[3 + c]->AutoSetTangents();
+			}
+			else
+			{
+				FloatChannels[3 + c]->Reset();
+			}
+			Rotation[c].Reset();
+		}
+		Times.Reset();
+	}
+};
@@ -0,0 +1,173 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CustomRenderProfiler.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Interfaces/IPluginManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCustomRenderProfile, Log, All);
+
+DEFINE_STAT(STAT_CustomRender_Cleanup);
+DEFINE_STAT(STAT_CustomRender_FactoryScan);
+DEFINE_STAT(STAT_CustomRender_Bounds);
+DEFINE_STAT(STAT_CustomRender_Cluster);
+DEFINE_STAT(STAT_CustomRender_Visibility);
+DEFINE_STAT(STAT_CustomRender_Spawn);
+DEFINE_STAT(STAT_CustomRender_Bind);
+DEFINE_STAT(STAT_CustomRender_OrbitMath);
+DEFINE_STAT(STAT_CustomRender_Key);
+DEFINE_STAT(STAT_CustomRender_Manifest);
+DEFINE_STAT(STAT_CustomRender_Viewport);
+DEFINE_STAT(STAT_CustomRender_CamerasSpawned);
+DEFINE_STAT(STAT_CustomRender_CamerasReused);
+DEFINE_STAT(STAT_CustomRender_KeysWritten);
+
+bool FCustomRenderProfiler::bRunning = false;
+double FCustomRenderProfiler::StartTime = 0.0;
+double FCustomRenderProfiler::StartProcessPeakMB = 0.0;
+FCustomRenderProfile FCustomRenderProfiler::Run;
+
+static const TCHAR* PhaseNames[(int32)ECustomRenderPhase::Num] =
+{
+	TEXT("Cleanup"), TEXT("FactoryScan"), TEXT("Bounds"), TEXT("Cluster"), TEXT("Visibility"), TEXT("Spawn"), TEXT("Bind"),
+	TEXT("OrbitMath"), TEXT("Key"), TEXT("Manifest"), TEXT("Viewport")
+};
+
+bool FCustomRenderProfiler::Begin(int32 InNumTargets)
+{
+	if (bRunning)
+	{
+		return false;
+	}
+
+	bRunning = true;
+	Run = FCustomRenderProfile();
+	Run.NumTargets = InNumTargets;
+	StartTime = FPlatformTime::Seconds();
+	SampleMemory(Run.StartUsedMB, StartProcessPeakMB);
+	return true;
+}
+
+void FCustomRenderProfiler::SampleMemory(double& OutUsedMB, double& OutProcessPeakMB)
+{
+	const FPlatformMemoryStats Stats = FPlatformMemory::GetStats();
+	OutUsedMB = Stats.UsedPhysical / (1024.0 * 1024.0);
+	OutProcessPeakMB = Stats.PeakUsedPhysical / (1024.0 * 1024.0);
+}
+
+double FCustomRenderProfiler::PeakBetween(double StartUsedMB, double StartProcessPeakMB, double EndUsedMB, double EndProcessPeakMB)
+{
+	const double Sampled = FMath::Max(StartUsedMB, EndUsedMB);
+	return EndProcessPeakMB > StartProcessPeakMB ? FMath::Max(Sampled, EndProcessPeakMB) : Sampled;
+}
+
+void FCustomRenderProfiler::AddCameras(int32 Spawned, int32 Reused)
+{
+	Run.CamerasSpawned += Spawned;
+	Run.CamerasReused += Reused;
+	INC_DWORD_STAT_BY(STAT_CustomRender_CamerasSpawned, Spawned);
+	INC_DWORD_STAT_BY(STAT_CustomRender_CamerasReused, Reused);
+}
+
+void FCustomRenderProfiler::AddKeys(int32 Keys)
+{
+	Run.KeysWritten += Keys;
+	INC_DWORD_STAT_BY(STAT_CustomRender_KeysWritten, Keys);
+}
+
+FCustomRenderProfiler::FPhaseScope::FPhaseScope(ECustomRenderPhase InPhase)
+	: Phase(InPhase)
+	, StartTime(FPlatformTime::Seconds())
+{
+	SampleMemory(StartUsedMB, StartProcessPeakMB);
+}
+
+FCustomRenderProfiler::FPhaseScope::~FPhaseScope()
+{
+	Run.PhaseSeconds[(int32)Phase] += FPlatformTime::Seconds() - StartTime;
+
+	// Only this phase's scope writes its slot, so the worker timing OrbitMath never races the game thread
+	double EndUsedMB, EndProcessPeakMB;
+	SampleMemory(EndUsedMB, EndProcessPeakMB);
+	double& PhasePeak = Run.PhasePeakUsedMB[(int32)Phase];
+	PhasePeak = FMath::Max(PhasePeak, PeakBetween(StartUsedMB, StartProcessPeakMB, EndUsedMB, EndProcessPeakMB));
+}
+
+const TCHAR* FCustomRenderProfiler::GetPhaseName(ECustomRenderPhase Phase)
+{
+	return PhaseNames[(int32)Phase];
+}
+
+void FCustomRenderProfiler::End()
+{
+	if (!bRunning)
+	{
+		return;
+	}
+	bRunning = false;
+
+	Run.TotalSeconds = FPlatformTime::Seconds() - StartTime;
+
+	double EndUsedMB, EndProcessPeakMB;
+	SampleMemory(EndUsedMB, EndProcessPeakMB);
+	Run.PeakUsedMB = PeakBetween(Run.StartUsedMB, StartProcessPeakMB, EndUsedMB, EndProcessPeakMB);
+	for (double PhasePeak : Run.PhasePeakUsedMB)
+	{
+		Run.PeakUsedMB = FMath::Max(Run.PeakUsedMB, PhasePeak);
+	}
+
+	const double TotalSeconds = Run.TotalSeconds;
+	const int32 NumTargets = Run.NumTargets;
+	const int32 CamerasSpawned = Run.CamerasSpawned;
+	const int32 CamerasReused = Run.CamerasReused;
+	const int64 KeysWritten = Run.KeysWritten;
+	const double StartUsedMB = Run.StartUsedMB;
+	const double PeakUsedMB = Run.PeakUsedMB;
+	const double* PhaseSeconds = Run.PhaseSeconds;
+
+	const int32 Cameras = CamerasSpawned + CamerasReused;
+	const double CamerasPerSecond = TotalSeconds > 0.0 ? Cameras / TotalSeconds : 0.0;
+	const double KeysPerSecond = TotalSeconds > 0.0 ? KeysWritten / TotalSeconds : 0.0;
+
+	TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("CustomRender"));
+	const FString Version = Plugin.IsValid() ? Plugin->GetDescriptor().VersionName : FString();
+
+	// Log
+	FString Phases;
+	for (int32 p = 0; p < (int32)ECustomRenderPhase::Num; p++)
+	{
+		Phases += FString::Printf(TEXT(" %s %.1f ms"), PhaseNames[p], PhaseSeconds[p] * 1000.0);
+	}
+	UE_LOG(LogCustomRenderProfile, Display, TEXT("%d targets in %.1f ms:%s"), NumTargets, TotalSeconds * 1000.0, *Phases);
+	UE_LOG(LogCustomRenderProfile, Display, TEXT("%d cameras spawned, %d reused, %.0f cameras/s, %lld keys, %.0f keys/s, memory peak %.1f MB (%+.1f MB)"),
+		CamerasSpawned, CamerasReused, CamerasPerSecond, KeysWritten, KeysPerSecond, PeakUsedMB, PeakUsedMB - StartUsedMB);
+
+	// CSV, one row per run
+	const FString Path = FPaths::ProjectSavedDir() / TEXT("CustomRender") / TEXT("Profile.csv");
+	FString Row;
+	if (!IFileManager::Get().FileExists(*Path))
+	{
+		Row += TEXT("Time,Version,Targets,TotalMs");
+		for (const TCHAR* Name : PhaseNames)
+		{
+			Row += FString::Printf(TEXT(",%sMs"), Name);
+		}
+		Row += TEXT(",CamerasSpawned,CamerasReused,CamerasPerSecond,Keys,KeysPerSecond,StartUsedMB,PeakUsedMB") LINE_TERMINATOR;
+	}
+
+	Row += FString::Printf(TEXT("%s,%s,%d,%.3f"), *FDateTime::Now().ToString(), *Version, NumTargets, TotalSeconds * 1000.0);
+	for (int32 p = 0; p < (int32)ECustomRenderPhase::Num; p++)
+	{
+		Row += FString::Printf(TEXT(",%.3f"), PhaseSeconds[p] * 1000.0);
+	}
+	Row += FString::Printf(TEXT(",%d,%d,%.1f,%lld,%.1f,%.1f,%.1f"), CamerasSpawned, CamerasReused, CamerasPerSecond, KeysWritten, KeysPerSecond, StartUsedMB, PeakUsedMB) + LINE_TERMINATOR;
+
+	if (!FFileHelper::SaveStringToFile(Row, *Path, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append))
+	{
+		UE_LOG(LogCustomRenderProfile, Warning, TEXT("Can't write %s"), *Path);
+	}
+}
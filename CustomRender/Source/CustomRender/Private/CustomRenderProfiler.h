@@ -0,0 +1,116 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("CustomRender"), STATGROUP_CustomRender, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Cleanup"), STAT_CustomRender_Cleanup, STATGROUP_CustomRender, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Factory Scan"), STAT_CustomRender_FactoryScan, STATGROUP_CustomRender, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bounds"), STAT_CustomRender_Bounds, STATGROUP_CustomRender, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Cluster"), STAT_CustomRender_Cluster, STATGROUP_CustomRender, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Visibility"), STAT_CustomRender_Visibility, STATGROUP_CustomRender, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spawn"), STAT_CustomRender_Spawn, STATGROUP_CustomRender, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bind"), STAT_CustomRender_Bind, STATGROUP_CustomRender, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Orbit Math"), STAT_CustomRender_OrbitMath, STATGROUP_CustomRender, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Key"), STAT_CustomRender_Key, STATGROUP_CustomRender, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Manifest"), STAT_CustomRender_Manifest, STATGROUP_CustomRender, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Viewport"), STAT_CustomRender_Viewport, STATGROUP_CustomRender, );
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Cameras Spawned"), STAT_CustomRender_CamerasSpawned, STATGROUP_CustomRender, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Cameras Reused"), STAT_CustomRender_CamerasReused, STATGROUP_CustomRender, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Keys Written"), STAT_CustomRender_KeysWritten, STATGROUP_CustomRender, );
+
+/** Phases of one generation run, in the order they appear in the summary. */
+enum class ECustomRenderPhase : uint8
+{
+	Cleanup,
+	FactoryScan,
+	Bounds,
+	Cluster,
+	Visibility,
+	Spawn,
+	Bind,
+	OrbitMath,
+	Key,
+	Manifest,
+	Viewport,
+	Num
+};
+
+/** Numbers of one generation run. */
+struct FCustomRenderProfile
+{
+	int32 NumTargets = 0;
+	int32 CamerasSpawned = 0;
+	int32 CamerasReused = 0;
+	int64 KeysWritten = 0;
+	double TotalSeconds = 0.0;
+	double PhaseSeconds[(int32)ECustomRenderPhase::Num] = {};
+
+	/**
+	 * Used physical memory when the run started, and the most it reached during the run and during each phase.
+	 * Peaks are sampled where phases begin and end. The platform's peak counter catches spikes within a phase,
+	 * but only spikes that set a new peak for the whole process.
+	 */
+	double StartUsedMB = 0.0;
+	double PeakUsedMB = 0.0;
+	double PhasePeakUsedMB[(int32)ECustomRenderPhase::Num] = {};
+};
+
+/**
+ * Times the phases of a generation run and counts what it created. A run ends with a summary
+ * in the log and one row appended to Saved/CustomRender/Profile.csv.
+ * Each phase is only ever timed from one thread at a time, the orbit math runs on a worker.
+ */
+class FCustomRenderProfiler
+{
+public:
+
+	/** Start a run, false when one is already running and the caller shouldn't end it */
+	static bool Begin(int32 NumTargets);
+
+	/** End the run and report it */
+	static void End();
+
+	/** The last run that ended */
+	static const FCustomRenderProfile& GetLastRun() { return Run; }
+
+	static const TCHAR* GetPhaseName(ECustomRenderPhase Phase);
+
+	static void AddCameras(int32 Spawned, int32 Reused);
+
+	static void AddKeys(int32 Keys);
+
+	struct FPhaseScope
+	{
+		FPhaseScope(ECustomRenderPhase InPhase);
+		~FPhaseScope();
+
+		ECustomRenderPhase Phase;
+		double StartTime;
+		double StartUsedMB;
+		double StartProcessPeakMB;
+	};
+
+private:
+
+	/** Used physical memory now, and the process peak of used physical memory so far */
+	static void SampleMemory(double& OutUsedMB, double& OutProcessPeakMB);
+
+	/** Highest used memory between two samples, the process peak only counts when it rose in between */
+	static double PeakBetween(double StartUsedMB, double StartProcessPeakMB, double EndUsedMB, double EndProcessPeakMB);
+
+	static bool bRunning;
+	static double StartTime;
+	static double StartProcessPeakMB;
+	static FCustomRenderProfile Run;
+};
+
+/** Time the rest of the scope as a phase: stat counter, named event for external profilers and run summary. */
+#define CUSTOMRENDER_SCOPE_PHASE(Phase) \
+	SCOPE_CYCLE_COUNTER(STAT_CustomRender_##Phase); \
+	SCOPED_NAMED_EVENT(CustomRender_##Phase, FColor::Orange); \
+	FCustomRenderProfiler::FPhaseScope ANONYMOUS_VARIABLE(CustomRenderPhase)(ECustomRenderPhase::Phase)
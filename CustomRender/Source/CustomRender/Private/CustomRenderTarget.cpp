@@ -0,0 +1,86 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "CustomRenderTarget.h"
+#include "GameFramework/Actor.h"
+#include "Components/InstancedStaticMeshComponent.h"
+
+FCustomRenderTarget::FCustomRenderTarget(UInstancedStaticMeshComponent* InComponent, int32 InInstance)
+	: Actor(InComponent ? InComponent->GetOwner() : nullptr)
+	, Component(InComponent)
+	, Instance(InInstance)
+{
+}
+
+bool FCustomRenderTarget::IsValid() const
+{
+	if (!Actor.IsValid()) return false;
+	if (!IsInstance()) return true;
+	return Component.IsValid() && Instance < Component->GetInstanceCount();
+}
+
+FString FCustomRenderTarget::GetLabel() const
+{
+	const FString ActorLabel = Actor.IsValid() ? Actor->GetActorLabel() : FString();
+	if (!IsInstance())
+	{
+		return ActorLabel;
+	}
+
+	const FString ComponentName = Component.IsValid() ? Component->GetName() : FString();
+	return FString::Printf(TEXT("%s_%s_%d"), *ActorLabel, *ComponentName, Instance);
+}
+
+FTransform FCustomRenderTarget::GetTransform() const
+{
+	if (!IsInstance())
+	{
+		return Actor.IsValid() ? Actor->GetActorTransform() : FTransform::Identity;
+	}
+
+	FTransform Transform = FTransform::Identity;
+	if (Component.IsValid())
+	{
+		Component->GetInstanceTransform(Instance, Transform, true);
+	}
+	return Transform;
+}
+
+void FCustomRenderTarget::Expand(const TArray<AActor*>& Actors, TArray<FCustomRenderTarget>& OutTargets)
+{
+	OutTargets.Reset(Actors.Num());
+
+	TArray<UInstancedStaticMeshComponent*> Instanced;
+	for (AActor* Actor : Actors)
+	{
+		// Any other primitive means the instances are part of a larger object
+		bool bOnlyInstances = true;
+		Instanced.Reset();
+		for (UActorComponent* ActorComponent : Actor->GetComponents())
+		{
+			if (UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(ActorComponent))
+			{
+				Instanced.Add(InstancedComponent);
+			}
+			else if (Cast<UPrimitiveComponent>(ActorComponent))
+			{
+				bOnlyInstances = false;
+			}
+		}
+
+		if (!bOnlyInstances || Instanced.Num() == 0)
+		{
+			OutTargets.Add(FCustomRenderTarget(Actor));
+			continue;
+		}
+
+		for (UInstancedStaticMeshComponent* InstancedComponent : Instanced)
+		{
+			const int32 NumInstances = InstancedComponent->GetInstanceCount();
+			OutTargets.Reserve(OutTargets.Num() + NumInstances);
+			for (int32 i = 0; i < NumInstances; i++)
+			{
+				OutTargets.Add(FCustomRenderTarget(InstancedComponent, i));
+			}
+		}
+	}
+}
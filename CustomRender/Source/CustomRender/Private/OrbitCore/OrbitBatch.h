@@ -0,0 +1,253 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Batched evaluation of many orbits at once.
+// Cameras are stored as a structure of arrays and every key of an orbit is evaluated with
+// vector sin/cos kernels: AVX2 (8 keys), SSE2 (4 keys) and a scalar tail using the same polynomial.
+// Define ORBITCORE_NO_SIMD to force the scalar path.
+
+#include "OrbitTrajectory.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(ORBITCORE_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define ORBITCORE_SSE2 1
+	#include <emmintrin.h>
+#else
+	#define ORBITCORE_SSE2 0
+#endif
+
+#if !defined(ORBITCORE_NO_SIMD) && defined(__AVX2__)
+	#define ORBITCORE_AVX2 1
+	#include <immintrin.h>
+#else
+	#define ORBITCORE_AVX2 0
+#endif
+
+namespace OrbitCore
+{
+	/** Orbit parameters of many cameras, one entry per camera in every array. */
+	struct OrbitBatch
+	{
+		std::vector<float> OriginX, OriginY, Height, Radius;
+		std::vector<float> StartAngle, RangeAngle; // Radians
+
+		size_t Num() const { return Radius.size(); }
+
+		void Reserve(size_t Count)
+		{
+			for (auto Array : { &OriginX, &OriginY, &Height, &Radius, &StartAngle, &RangeAngle }) Array->reserve(Count);
+		}
+
+		void Clear()
+		{
+			for (auto Array : { &OriginX, &OriginY, &Height, &Radius, &StartAngle, &RangeAngle }) Array->clear();
+		}
+
+		/** @return The index of the added camera */
+		size_t Add(const OrbitParams & P)
+		{
+			OriginX.push_back(float(P.Origin.X));
+			OriginY.push_back(float(P.Origin.Y));
+			Height.push_back(float(P.CameraHeight));
+			Radius.push_back(float(OrbitRadius(P)));
+			StartAngle.push_back(float(DegreesToRadians(P.StartAngle)));
+			RangeAngle.push_back(float(DegreesToRadians(P.EndAngle - P.StartAngle)));
+			return Num() - 1;
+		}
+	};
+
+	/** Positions of a batch, NumKeys consecutive entries per camera or KeysPerCamera entries when those differ. */
+	struct OrbitBatchPositions
+	{
+		int NumKeys = 0;
+		std::vector<float> X, Y, Z;
+
+		// Only used when cameras have their own key count
+		std::vector<size_t> Offsets;
+		std::vector<int> KeysPerCamera;
+
+		void Resize(size_t NumCameras, int InNumKeys)
+		{
+			NumKeys = InNumKeys;
+			Offsets.clear();
+			KeysPerCamera.clear();
+			X.resize(NumCameras * NumKeys);
+			Y.resize(NumCameras * NumKeys);
+			Z.resize(NumCameras * NumKeys);
+		}
+
+		void Resize(const std::vector<int> & InKeysPerCamera)
+		{
+			NumKeys = 0;
+			KeysPerCamera = InKeysPerCamera;
+			Offsets.resize(KeysPerCamera.size());
+
+			size_t Total = 0;
+			for (size_t i = 0; i < KeysPerCamera.size(); i++)
+			{
+				Offsets[i] = Total;
+				Total += size_t(std::max(KeysPerCamera[i], 0));
+			}
+			X.resize(Total);
+			Y.resize(Total);
+			Z.resize(Total);
+		}
+
+		size_t Offset(size_t Camera) const { return Offsets.empty() ? Camera * NumKeys : Offsets[Camera]; }
+		int NumKeysOf(size_t Camera) const { return KeysPerCamera.empty() ? NumKeys : KeysPerCamera[Camera]; }
+	};
+
+	namespace Detail
+	{
+		// pi/2 split in three parts for an accurate range reduction in single precision
+		constexpr float HalfPi1 = 1.5703125f;
+		constexpr float HalfPi2 = 4.837512969970703125e-4f;
+		constexpr float HalfPi3 = 7.54978995489188216e-8f;
+		constexpr float TwoOverPi = 0.636619772367581343f;
+
+		// Minimax polynomials on [-pi/4, pi/4]
+		constexpr float S1 = -1.6666654611e-1f, S2 = 8.3321608736e-3f, S3 = -1.9515295891e-4f;
+		constexpr float C1 = 4.166664568298827e-2f, C2 = -1.388731625493765e-3f, C3 = 2.443315711809948e-5f;
+
+		inline void SinCos(float X, float & OutSin, float & OutCos)
+		{
+			const int32_t Q = int32_t(std::lrint(X * TwoOverPi));
+			const float Y = float(Q);
+			const float R = ((X - Y * HalfPi1) - Y * HalfPi2) - Y * HalfPi3;
+			const float Z = R * R;
+
+			const float S = ((S3 * Z + S2) * Z + S1) * Z * R + R;
+			const float C = ((C3 * Z + C2) * Z + C1) * Z * Z - 0.5f * Z + 1.0f;
+
+			const bool bSwap = (Q & 1) != 0;
+			OutSin = bSwap ? C : S;
+			OutCos = bSwap ? S : C;
+			if (Q & 2) OutSin = -OutSin;
+			if ((Q + 1) & 2) OutCos = -OutCos;
+		}
+
+#if ORBITCORE_SSE2
+		inline void SinCos4(__m128 X, __m128 & OutSin, __m128 & OutCos)
+		{
+			const __m128i Q = _mm_cvtps_epi32(_mm_mul_ps(X, _mm_set1_ps(TwoOverPi)));
+			const __m128 Y = _mm_cvtepi32_ps(Q);
+			__m128 R = _mm_sub_ps(X, _mm_mul_ps(Y, _mm_set1_ps(HalfPi1)));
+			R = _mm_sub_ps(R, _mm_mul_ps(Y, _mm_set1_ps(HalfPi2)));
+			R = _mm_sub_ps(R, _mm_mul_ps(Y, _mm_set1_ps(HalfPi3)));
+			const __m128 Z = _mm_mul_ps(R, R);
+
+			__m128 S = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(S3), Z), _mm_set1_ps(S2));
+			S = _mm_add_ps(_mm_mul_ps(S, Z), _mm_set1_ps(S1));
+			S = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(S, Z), R), R);
+
+			__m128 C = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(C3), Z), _mm_set1_ps(C2));
+			C = _mm_add_ps(_mm_mul_ps(C, Z), _mm_set1_ps(C1));
+			C = _mm_mul_ps(_mm_mul_ps(C, Z), Z);
+			C = _mm_add_ps(_mm_sub_ps(C, _mm_mul_ps(_mm_set1_ps(0.5f), Z)), _mm_set1_ps(1.0f));
+
+			const __m128i One = _mm_set1_epi32(1), Two = _mm_set1_epi32(2);
+			const __m128 Swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(Q, One), One));
+			const __m128 SinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(Q, Two), 30));
+			const __m128 CosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(Q, One), Two), 30));
+
+			OutSin = _mm_xor_ps(_mm_or_ps(_mm_and_ps(Swap, C), _mm_andnot_ps(Swap, S)), SinSign);
+			OutCos = _mm_xor_ps(_mm_or_ps(_mm_and_ps(Swap, S), _mm_andnot_ps(Swap, C)), CosSign);
+		}
+#endif
+
+#if ORBITCORE_AVX2
+		inline void SinCos8(__m256 X, __m256 & OutSin, __m256 & OutCos)
+		{
+			const __m256i Q = _mm256_cvtps_epi32(_mm256_mul_ps(X, _mm256_set1_ps(TwoOverPi)));
+			const __m256 Y = _mm256_cvtepi32_ps(Q);
+			__m256 R = _mm256_sub_ps(X, _mm256_mul_ps(Y, _mm256_set1_ps(HalfPi1)));
+			R = _mm256_sub_ps(R, _mm256_mul_ps(Y, _mm256_set1_ps(HalfPi2)));
+			R = _mm256_sub_ps(R, _mm256_mul_ps(Y, _mm256_set1_ps(HalfPi3)));
+			const __m256 Z = _mm256_mul_ps(R, R);
+
+			__m256 S = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(S3), Z), _mm256_set1_ps(S2));
+			S = _mm256_add_ps(_mm256_mul_ps(S, Z), _mm256_set1_ps(S1));
+			S = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(S, Z), R), R);
+
+			__m256 C = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(C3), Z), _mm256_set1_ps(C2));
+			C = _mm256_add_ps(_mm256_mul_ps(C, Z), _mm256_set1_ps(C1));
+			C = _mm256_mul_ps(_mm256_mul_ps(C, Z), Z);
+			C = _mm256_add_ps(_mm256_sub_ps(C, _mm256_mul_ps(_mm256_set1_ps(0.5f), Z)), _mm256_set1_ps(1.0f));
+
+			const __m256i One = _mm256_set1_epi32(1), Two = _mm256_set1_epi32(2);
+			const __m256 Swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(Q, One), One));
+			const __m256 SinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(Q, Two), 30));
+			const __m256 CosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(Q, One), Two), 30));
+
+			OutSin = _mm256_xor_ps(_mm256_blendv_ps(S, C, Swap), SinSign);
+			OutCos = _mm256_xor_ps(_mm256_blendv_ps(C, S, Swap), CosSign);
+		}
+#endif
+	}
+
+	/** Evaluate NumKeys evenly timed positions of one orbit, angles in radians. */
+	inline void EvaluateOrbit(float OriginX, float OriginY, float Height, float Radius, float StartAngle, float RangeAngle,
+		int NumKeys, float * OutX, float * OutY, float * OutZ)
+	{
+		const float Step = NumKeys > 1 ? RangeAngle / float(NumKeys - 1) : 0.0f;
+		int k = 0;
+
+#if ORBITCORE_AVX2
+		{
+			const __m256 Offsets = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+			for (; k + 8 <= NumKeys; k += 8)
+			{
+				const __m256 Index = _mm256_add_ps(_mm256_set1_ps(float(k)), Offsets);
+				const __m256 Theta = _mm256_add_ps(_mm256_set1_ps(StartAngle), _mm256_mul_ps(Index, _mm256_set1_ps(Step)));
+				__m256 S, C;
+				Detail::SinCos8(Theta, S, C);
+				_mm256_storeu_ps(OutX + k, _mm256_add_ps(_mm256_set1_ps(OriginX), _mm256_mul_ps(_mm256_set1_ps(Radius), C)));
+				_mm256_storeu_ps(OutY + k, _mm256_add_ps(_mm256_set1_ps(OriginY), _mm256_mul_ps(_mm256_set1_ps(Radius), S)));
+				_mm256_storeu_ps(OutZ + k, _mm256_set1_ps(Height));
+			}
+		}
+#endif
+
+#if ORBITCORE_SSE2
+		{
+			const __m128 Offsets = _mm_setr_ps(0, 1, 2, 3);
+			for (; k + 4 <= NumKeys; k += 4)
+			{
+				const __m128 Index = _mm_add_ps(_mm_set1_ps(float(k)), Offsets);
+				const __m128 Theta = _mm_add_ps(_mm_set1_ps(StartAngle), _mm_mul_ps(Index, _mm_set1_ps(Step)));
+				__m128 S, C;
+				Detail::SinCos4(Theta, S, C);
+				_mm_storeu_ps(OutX + k, _mm_add_ps(_mm_set1_ps(OriginX), _mm_mul_ps(_mm_set1_ps(Radius), C)));
+				_mm_storeu_ps(OutY + k, _mm_add_ps(_mm_set1_ps(OriginY), _mm_mul_ps(_mm_set1_ps(Radius), S)));
+				_mm_storeu_ps(OutZ + k, _mm_set1_ps(Height));
+			}
+		}
+#endif
+
+		for (; k < NumKeys; k++)
+		{
+			float S, C;
+			Detail::SinCos(StartAngle + float(k) * Step, S, C);
+			OutX[k] = OriginX + Radius * C;
+			OutY[k] = OriginY + Radius * S;
+			OutZ[k] = Height;
+		}
+	}
+
+	/** Evaluate cameras [Begin, End) of a batch into Out, which must be sized for the whole batch. */
+	inline void EvaluateBatch(const OrbitBatch & Batch, size_t Begin, size_t End, OrbitBatchPositions & Out)
+	{
+		for (size_t i = Begin; i < End; i++)
+		{
+			const int NumKeys = Out.NumKeysOf(i);
+			if (NumKeys <= 0) continue;
+
+			const size_t Offset = Out.Offset(i);
+			EvaluateOrbit(Batch.OriginX[i], Batch.OriginY[i], Batch.Height[i], Batch.Radius[i], Batch.StartAngle[i], Batch.RangeAngle[i],
+				NumKeys, &Out.X[Offset], &Out.Y[Offset], &Out.Z[Offset]);
+		}
+	}
+}
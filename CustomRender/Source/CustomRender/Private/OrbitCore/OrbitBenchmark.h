@@ -0,0 +1,100 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Pure math benchmark of the orbit code on a synthetic grid of targets.
+// Plain C++ like the rest of OrbitCore, any host can time it with a call to RunBenchmark;
+// the CustomRenderBenchmark commandlet runs the same code with -MathOnly, and OrbitCoreBench --sweep
+// without Unreal.
+
+#include "OrbitBatch.h"
+#include "OrbitKeyReduction.h"
+
+#include <chrono>
+
+namespace OrbitCore
+{
+	struct BenchmarkResult
+	{
+		int NumOrbits;
+		int KeysPerOrbit;
+		double ReferenceSeconds;  // Scalar double precision GenerateKeys, one orbit after the other
+		double BatchSeconds;      // EvaluateBatch over all orbits at once
+		double MinimalSeconds;    // FitOrbitKeys of every orbit
+		size_t MinimalKeys;       // Keys kept by FitOrbitKeys over all orbits
+		double Checksum;          // Keeps the compiler from dropping the work
+	};
+
+	/** Orbits around a square grid of targets, the same layout the benchmark commandlet spawns. */
+	inline void MakeSyntheticOrbits(int NumOrbits, std::vector<OrbitParams> & Out, double Spacing = 300.0, double HalfSize = 50.0)
+	{
+		const int Side = std::max(1, int(std::ceil(std::sqrt(double(NumOrbits)))));
+		Out.clear();
+		Out.reserve(std::max(NumOrbits, 0));
+		for (int i = 0; i < NumOrbits; i++)
+		{
+			OrbitParams P;
+			P.Origin = Vec3{ (i % Side) * Spacing, (i / Side) * Spacing, HalfSize };
+			P.Extent = Vec3{ HalfSize, HalfSize, HalfSize };
+			P.RadiusMultiplier = 3.0;
+			P.CameraHeight = 150.0;
+			P.StartAngle = 0.0;
+			P.EndAngle = 180.0;
+			Out.push_back(P);
+		}
+	}
+
+	/** Time every way of keying NumOrbits orbits, single threaded. */
+	inline BenchmarkResult RunBenchmark(int NumOrbits, int KeysPerOrbit, double MaxError)
+	{
+		using Clock = std::chrono::steady_clock;
+		auto Seconds = [](Clock::time_point Start) { return std::chrono::duration<double>(Clock::now() - Start).count(); };
+
+		std::vector<OrbitParams> Orbits;
+		MakeSyntheticOrbits(NumOrbits, Orbits);
+
+		BenchmarkResult Result = {};
+		Result.NumOrbits = NumOrbits;
+		Result.KeysPerOrbit = KeysPerOrbit;
+
+		// Reference
+		{
+			const auto Start = Clock::now();
+			std::vector<OrbitKey> Keys;
+			for (const OrbitParams & P : Orbits)
+			{
+				GenerateKeys(P, KeysPerOrbit, Keys);
+				if (!Keys.empty()) Result.Checksum += Keys.back().Position.X;
+			}
+			Result.ReferenceSeconds = Seconds(Start);
+		}
+
+		// Batched SIMD evaluation
+		{
+			const auto Start = Clock::now();
+			OrbitBatch Batch;
+			Batch.Reserve(Orbits.size());
+			for (const OrbitParams & P : Orbits) Batch.Add(P);
+
+			OrbitBatchPositions Positions;
+			Positions.Resize(Batch.Num(), KeysPerOrbit);
+			EvaluateBatch(Batch, 0, Batch.Num(), Positions);
+			Result.BatchSeconds = Seconds(Start);
+			if (!Positions.X.empty()) Result.Checksum += Positions.X.back();
+		}
+
+		// Minimal keys
+		{
+			const auto Start = Clock::now();
+			std::vector<TangentKey> Keys;
+			for (const OrbitParams & P : Orbits)
+			{
+				FitOrbitKeys(P, MaxError, Keys);
+				Result.MinimalKeys += Keys.size();
+			}
+			Result.MinimalSeconds = Seconds(Start);
+		}
+
+		return Result;
+	}
+}
@@ -0,0 +1,144 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Groups nearby objects so one orbit can cover all of them.
+// Objects are hashed into a uniform grid by their bounds, pairs in neighbouring cells that are
+// closer than the link gap are merged closest first with a union-find, and a merge is refused when
+// the combined bounds would grow past the size limit. Large objects therefore stay on their own.
+
+#include "OrbitTrajectory.h"
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace OrbitCore
+{
+	/** Axis aligned bounds, as a center and a half size like the engine's box extent. */
+	struct ClusterBounds
+	{
+		Vec3 Center;
+		Vec3 Extent;
+	};
+
+	struct ClusterParams
+	{
+		double MaxGap = 50.0;    // Largest distance between two bounds boxes that still links them
+		double MaxSize = 300.0;  // Largest size of the combined bounds along any axis
+	};
+
+	/** Smallest box holding both A and B. */
+	inline ClusterBounds UnionBounds(const ClusterBounds & A, const ClusterBounds & B)
+	{
+		const double MinX = std::min(A.Center.X - A.Extent.X, B.Center.X - B.Extent.X);
+		const double MinY = std::min(A.Center.Y - A.Extent.Y, B.Center.Y - B.Extent.Y);
+		const double MinZ = std::min(A.Center.Z - A.Extent.Z, B.Center.Z - B.Extent.Z);
+		const double MaxX = std::max(A.Center.X + A.Extent.X, B.Center.X + B.Extent.X);
+		const double MaxY = std::max(A.Center.Y + A.Extent.Y, B.Center.Y + B.Extent.Y);
+		const double MaxZ = std::max(A.Center.Z + A.Extent.Z, B.Center.Z + B.Extent.Z);
+		return ClusterBounds{
+			Vec3{ (MinX + MaxX) * 0.5, (MinY + MaxY) * 0.5, (MinZ + MaxZ) * 0.5 },
+			Vec3{ (MaxX - MinX) * 0.5, (MaxY - MinY) * 0.5, (MaxZ - MinZ) * 0.5 } };
+	}
+
+	/** Distance between the surfaces of two boxes, 0 when they overlap. */
+	inline double BoundsGap(const ClusterBounds & A, const ClusterBounds & B)
+	{
+		const double DX = std::max(0.0, std::fabs(A.Center.X - B.Center.X) - A.Extent.X - B.Extent.X);
+		const double DY = std::max(0.0, std::fabs(A.Center.Y - B.Center.Y) - A.Extent.Y - B.Extent.Y);
+		const double DZ = std::max(0.0, std::fabs(A.Center.Z - B.Center.Z) - A.Extent.Z - B.Extent.Z);
+		return std::sqrt(DX * DX + DY * DY + DZ * DZ);
+	}
+
+	/**
+	 * Split objects into clusters. Every object ends up in exactly one cluster, members are listed
+	 * in increasing index order and clusters are ordered by their first member.
+	 */
+	inline std::vector<std::vector<int>> ClusterObjects(const std::vector<ClusterBounds> & Objects, const ClusterParams & P)
+	{
+		const int Num = int(Objects.size());
+
+		// A box that fits in a cluster is at most MaxSize wide, so linked centers are at most
+		// MaxSize + MaxGap apart and one cell of that size only needs its direct neighbours
+		const double CellSize = std::max(P.MaxSize + P.MaxGap, 1.0);
+		auto CellOf = [&](double V) { return int64_t(std::floor(V / CellSize)); };
+		auto CellKey = [](int64_t X, int64_t Y, int64_t Z) {
+			return uint64_t(X & 0x1FFFFF) | (uint64_t(Y & 0x1FFFFF) << 21) | (uint64_t(Z & 0x1FFFFF) << 42);
+		};
+
+		auto Fits = [&](const ClusterBounds & B) {
+			return 2.0 * std::max(B.Extent.X, std::max(B.Extent.Y, B.Extent.Z)) <= P.MaxSize;
+		};
+
+		std::unordered_map<uint64_t, std::vector<int>> Grid;
+		for (int i = 0; i < Num; i++)
+		{
+			if (!Fits(Objects[i])) continue;
+			const Vec3 & C = Objects[i].Center;
+			Grid[CellKey(CellOf(C.X), CellOf(C.Y), CellOf(C.Z))].push_back(i);
+		}
+
+		// Candidate links, each pair once
+		struct Link { double Gap; int A, B; };
+		std::vector<Link> Links;
+		for (int i = 0; i < Num; i++)
+		{
+			if (!Fits(Objects[i])) continue;
+			const Vec3 & C = Objects[i].Center;
+			const int64_t X = CellOf(C.X), Y = CellOf(C.Y), Z = CellOf(C.Z);
+			for (int64_t DX = -1; DX <= 1; DX++)
+			for (int64_t DY = -1; DY <= 1; DY++)
+			for (int64_t DZ = -1; DZ <= 1; DZ++)
+			{
+				auto Cell = Grid.find(CellKey(X + DX, Y + DY, Z + DZ));
+				if (Cell == Grid.end()) continue;
+				for (int j : Cell->second)
+				{
+					if (j <= i) continue;
+					const double Gap = BoundsGap(Objects[i], Objects[j]);
+					if (Gap <= P.MaxGap) Links.push_back(Link{ Gap, i, j });
+				}
+			}
+		}
+		std::sort(Links.begin(), Links.end(), [](const Link & L, const Link & R) {
+			return L.Gap != R.Gap ? L.Gap < R.Gap : (L.A != R.A ? L.A < R.A : L.B < R.B);
+		});
+
+		// Closest pairs merge first, as long as the cluster stays small enough
+		std::vector<int> Parent(Num);
+		std::vector<ClusterBounds> Bounds(Objects);
+		for (int i = 0; i < Num; i++) Parent[i] = i;
+
+		auto Find = [&](int i) {
+			while (Parent[i] != i) i = Parent[i] = Parent[Parent[i]];
+			return i;
+		};
+
+		for (const Link & L : Links)
+		{
+			const int A = Find(L.A), B = Find(L.B);
+			if (A == B) continue;
+
+			const ClusterBounds Merged = UnionBounds(Bounds[A], Bounds[B]);
+			if (!Fits(Merged)) continue;
+
+			const int Root = std::min(A, B);
+			Parent[std::max(A, B)] = Root;
+			Bounds[Root] = Merged;
+		}
+
+		std::vector<std::vector<int>> Clusters;
+		std::vector<int> ClusterOfRoot(Num, -1);
+		for (int i = 0; i < Num; i++)
+		{
+			const int Root = Find(i);
+			if (ClusterOfRoot[Root] < 0)
+			{
+				ClusterOfRoot[Root] = int(Clusters.size());
+				Clusters.emplace_back();
+			}
+			Clusters[ClusterOfRoot[Root]].push_back(i);
+		}
+		return Clusters;
+	}
+}
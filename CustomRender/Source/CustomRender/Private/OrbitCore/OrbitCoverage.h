@@ -0,0 +1,182 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Coverage driven view planning: instead of a fixed orbit, pick the fewest view directions that
+// together see a target share of the directions around an object, then order them into a short path.
+//
+// Candidate views and the directions to cover are both Fibonacci points on the band of the unit
+// sphere between MinElevation and MaxElevation. A view covers every direction within ViewAngle of it.
+// The set is chosen greedily (largest number of newly covered directions first), which is within
+// a log factor of the smallest set. The plan doesn't depend on the object, only on the parameters,
+// so it is computed once and scaled to each object's bounds.
+
+#include "OrbitTrajectory.h"
+
+#include <cstdint>
+
+namespace OrbitCore
+{
+	struct CoverageParams
+	{
+		double MinElevation = 0.0;    // Degrees above the horizontal plane through the origin
+		double MaxElevation = 60.0;
+		double ViewAngle = 25.0;      // Degrees, half angle of the directions one view covers
+		double TargetCoverage = 0.95; // Share of the sampled directions to cover
+		int NumCandidates = 256;
+		int NumSamples = 2048;
+	};
+
+	/** N unit directions spread evenly over the sphere band between two elevations, in degrees. */
+	inline std::vector<Vec3> FibonacciDirections(int N, double MinElevation, double MaxElevation)
+	{
+		const double GoldenAngle = Pi * (3.0 - std::sqrt(5.0));
+		const double ZMin = std::sin(DegreesToRadians(std::min(MinElevation, MaxElevation)));
+		const double ZMax = std::sin(DegreesToRadians(std::max(MinElevation, MaxElevation)));
+
+		std::vector<Vec3> Out;
+		Out.reserve(std::max(N, 0));
+		for (int i = 0; i < N; i++)
+		{
+			// Uniform in Z is uniform in area on a sphere
+			const double Z = ZMin + (ZMax - ZMin) * (double(i) + 0.5) / double(N);
+			const double R = std::sqrt(std::max(0.0, 1.0 - Z * Z));
+			const double Phi = GoldenAngle * i;
+			Out.push_back(Vec3{ R * std::cos(Phi), R * std::sin(Phi), Z });
+		}
+		return Out;
+	}
+
+	inline double Dot(const Vec3 & A, const Vec3 & B) { return A.X * B.X + A.Y * B.Y + A.Z * B.Z; }
+
+	/** Share of Samples within ViewAngle degrees of at least one of Views. */
+	inline double MeasureCoverage(const std::vector<Vec3> & Views, const std::vector<Vec3> & Samples, double ViewAngle)
+	{
+		if (Samples.empty()) return 1.0;
+
+		const double CosAngle = std::cos(DegreesToRadians(ViewAngle));
+		size_t Covered = 0;
+		for (const Vec3 & S : Samples)
+		{
+			for (const Vec3 & V : Views)
+			{
+				if (Dot(S, V) >= CosAngle) { Covered++; break; }
+			}
+		}
+		return double(Covered) / double(Samples.size());
+	}
+
+	/** Reorder Views into a short open path: nearest neighbour from the lowest view heading along +X, then 2-opt. */
+	inline void OrderViewPath(std::vector<Vec3> & Views)
+	{
+		const size_t N = Views.size();
+		if (N < 3) return;
+
+		auto Distance = [&](size_t A, size_t B) {
+			const double DX = Views[A].X - Views[B].X, DY = Views[A].Y - Views[B].Y, DZ = Views[A].Z - Views[B].Z;
+			return std::sqrt(DX * DX + DY * DY + DZ * DZ);
+		};
+
+		// Start low and in front, like the orbits start at angle 0
+		size_t Start = 0;
+		for (size_t i = 1; i < N; i++)
+		{
+			const double Key = Views[i].Z - 0.1 * Views[i].X, Best = Views[Start].Z - 0.1 * Views[Start].X;
+			if (Key < Best) Start = i;
+		}
+
+		std::vector<size_t> Order;
+		std::vector<bool> Used(N, false);
+		Order.reserve(N);
+		Order.push_back(Start);
+		Used[Start] = true;
+		while (Order.size() < N)
+		{
+			size_t Next = N;
+			for (size_t i = 0; i < N; i++)
+			{
+				if (!Used[i] && (Next == N || Distance(Order.back(), i) < Distance(Order.back(), Next))) Next = i;
+			}
+			Order.push_back(Next);
+			Used[Next] = true;
+		}
+
+		// 2-opt on the open path, reverse any stretch that makes it shorter
+		for (bool bImproved = true; bImproved; )
+		{
+			bImproved = false;
+			for (size_t i = 0; i + 2 < N; i++)
+			{
+				for (size_t j = i + 2; j < N; j++)
+				{
+					const double Before = Distance(Order[i], Order[i + 1]) + (j + 1 < N ? Distance(Order[j], Order[j + 1]) : 0.0);
+					const double After = Distance(Order[i], Order[j]) + (j + 1 < N ? Distance(Order[i + 1], Order[j + 1]) : 0.0);
+					if (After + 1e-9 < Before)
+					{
+						std::reverse(Order.begin() + i + 1, Order.begin() + j + 1);
+						bImproved = true;
+					}
+				}
+			}
+		}
+
+		std::vector<Vec3> Ordered;
+		Ordered.reserve(N);
+		for (size_t i : Order) Ordered.push_back(Views[i]);
+		Views.swap(Ordered);
+	}
+
+	/** Unit view directions, in path order, that cover at least TargetCoverage of the sphere band. */
+	inline std::vector<Vec3> PlanCoverage(const CoverageParams & P)
+	{
+		const std::vector<Vec3> Candidates = FibonacciDirections(P.NumCandidates, P.MinElevation, P.MaxElevation);
+		const std::vector<Vec3> Samples = FibonacciDirections(P.NumSamples, P.MinElevation, P.MaxElevation);
+		const double CosAngle = std::cos(DegreesToRadians(P.ViewAngle));
+
+		// Directions each candidate sees
+		std::vector<std::vector<uint32_t>> Sees(Candidates.size());
+		for (size_t c = 0; c < Candidates.size(); c++)
+		{
+			for (size_t s = 0; s < Samples.size(); s++)
+			{
+				if (Dot(Candidates[c], Samples[s]) >= CosAngle) Sees[c].push_back(uint32_t(s));
+			}
+		}
+
+		std::vector<Vec3> Views;
+		std::vector<bool> Covered(Samples.size(), false);
+		const size_t Target = size_t(std::ceil(std::min(1.0, std::max(0.0, P.TargetCoverage)) * Samples.size()));
+		size_t NumCovered = 0;
+		std::vector<bool> Chosen(Candidates.size(), false);
+
+		while (NumCovered < Target)
+		{
+			size_t Best = Candidates.size(), BestGain = 0;
+			for (size_t c = 0; c < Candidates.size(); c++)
+			{
+				if (Chosen[c]) continue;
+				size_t Gain = 0;
+				for (uint32_t s : Sees[c]) Gain += Covered[s] ? 0 : 1;
+				if (Gain > BestGain) { Best = c; BestGain = Gain; }
+			}
+			if (Best == Candidates.size()) break; // Nothing left to gain, the target can't be reached
+
+			Chosen[Best] = true;
+			Views.push_back(Candidates[Best]);
+			for (uint32_t s : Sees[Best])
+			{
+				if (!Covered[s]) { Covered[s] = true; NumCovered++; }
+			}
+		}
+
+		OrderViewPath(Views);
+		return Views;
+	}
+
+	/** Position of a planned view around an orbit's target, at the orbit radius from its origin. */
+	inline Vec3 PlannedViewPosition(const OrbitParams & P, const Vec3 & Direction)
+	{
+		const double Radius = OrbitRadius(P);
+		return Vec3{ P.Origin.X + Radius * Direction.X, P.Origin.Y + Radius * Direction.Y, P.Origin.Z + Radius * Direction.Z };
+	}
+}
@@ -0,0 +1,195 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Fits an orbit with as few cubic keys as possible for a given position error.
+// Each channel of a circular arc is a sine, so a cubic Hermite segment spanning Alpha radians
+// deviates at most Radius * Alpha^4 / 384 from it. That gives the initial segment count, which
+// is then checked against the dense reference path and raised until the error bound holds.
+// A camera aimed at a fixed point is keyed at the same times, its pitch and yaw checked against
+// their own bound in degrees, since a close look-at point turns the camera faster than it moves.
+
+#include "OrbitTrajectory.h"
+
+namespace OrbitCore
+{
+	/** Key with an explicit tangent, Tangent is dPosition/dT in normalized shot time. */
+	struct TangentKey
+	{
+		double T;
+		Vec3 Position;
+		Vec3 Tangent;
+	};
+
+	/** Derivative of EvaluatePosition with respect to the normalized time T. */
+	inline Vec3 EvaluateTangent(const OrbitParams & P, double T)
+	{
+		const double Radius = OrbitRadius(P);
+		const double Range = DegreesToRadians(P.EndAngle - P.StartAngle);
+		const double Theta = DegreesToRadians(P.StartAngle) + T * Range;
+		return Vec3{ -Radius * std::sin(Theta) * Range, Radius * std::cos(Theta) * Range, 0.0 };
+	}
+
+	/** Rotation key of a camera aimed at a fixed point, angles in degrees and tangents in degrees per normalized time. */
+	struct RotationKey
+	{
+		double T;
+		double Pitch, Yaw;
+		double PitchTangent, YawTangent;
+	};
+
+	/** Angle in degrees equal to Angle modulo 360 and within 180 degrees of Reference. */
+	inline double UnwindDegrees(double Angle, double Reference)
+	{
+		return Reference + (Angle - Reference) - 360.0 * std::floor((Angle - Reference) / 360.0 + 0.5);
+	}
+
+	/** Pitch and yaw of the camera aimed at LookAt at normalized time T, and their derivatives. */
+	inline RotationKey EvaluateLookAt(const OrbitParams & P, const Vec3 & LookAt, double T)
+	{
+		const Vec3 Position = EvaluatePosition(P, T);
+		const Vec3 Velocity = EvaluateTangent(P, T);
+
+		RotationKey Key;
+		Key.T = T;
+		LookAtAngles(Position, LookAt, Key.Pitch, Key.Yaw);
+
+		// The direction to LookAt moves against the camera
+		const double DX = LookAt.X - Position.X, DY = LookAt.Y - Position.Y, DZ = LookAt.Z - Position.Z;
+		const double VX = -Velocity.X, VY = -Velocity.Y, VZ = -Velocity.Z;
+		const double Horizontal2 = DX * DX + DY * DY, Horizontal = std::sqrt(Horizontal2);
+		const double Length2 = Horizontal2 + DZ * DZ;
+		const double HorizontalRate = Horizontal > 0.0 ? (DX * VX + DY * VY) / Horizontal : 0.0;
+		Key.YawTangent = Horizontal2 > 0.0 ? (DX * VY - DY * VX) / Horizontal2 * (180.0 / Pi) : 0.0;
+		Key.PitchTangent = Length2 > 0.0 ? (Horizontal * VZ - DZ * HorizontalRate) / Length2 * (180.0 / Pi) : 0.0;
+		return Key;
+	}
+
+	/** Cubic Hermite interpolation of one value at S in [0, 1] of a segment H long, tangents per unit of T. */
+	inline double EvaluateHermite(double A, double TangentA, double B, double TangentB, double H, double S)
+	{
+		const double S2 = S * S, S3 = S2 * S;
+		return (2 * S3 - 3 * S2 + 1) * A + (S3 - 2 * S2 + S) * H * TangentA + (-2 * S3 + 3 * S2) * B + (S3 - S2) * H * TangentB;
+	}
+
+	/** Cubic Hermite interpolation between two keys, like a cubic key pair with user tangents. */
+	inline Vec3 EvaluateHermite(const TangentKey & A, const TangentKey & B, double T)
+	{
+		const double H = B.T - A.T;
+		const double S = H > 0 ? (T - A.T) / H : 0.0;
+		const double S2 = S * S, S3 = S2 * S;
+		const double H00 = 2 * S3 - 3 * S2 + 1, H10 = S3 - 2 * S2 + S;
+		const double H01 = -2 * S3 + 3 * S2, H11 = S3 - S2;
+		return Vec3{
+			H00 * A.Position.X + H10 * H * A.Tangent.X + H01 * B.Position.X + H11 * H * B.Tangent.X,
+			H00 * A.Position.Y + H10 * H * A.Tangent.Y + H01 * B.Position.Y + H11 * H * B.Tangent.Y,
+			H00 * A.Position.Z + H10 * H * A.Tangent.Z + H01 * B.Position.Z + H11 * H * B.Tangent.Z };
+	}
+
+	/** Largest distance between the keyed curve and the exact orbit, sampled SamplesPerSegment times per segment. */
+	inline double MaxKeyError(const OrbitParams & P, const std::vector<TangentKey> & Keys, int SamplesPerSegment = 16)
+	{
+		double MaxError = 0.0;
+		for (size_t k = 0; k + 1 < Keys.size(); k++)
+		{
+			for (int s = 1; s < SamplesPerSegment; s++)
+			{
+				const double T = Keys[k].T + (Keys[k + 1].T - Keys[k].T) * double(s) / double(SamplesPerSegment);
+				const Vec3 Fit = EvaluateHermite(Keys[k], Keys[k + 1], T);
+				const Vec3 Ref = EvaluatePosition(P, T);
+				const double DX = Fit.X - Ref.X, DY = Fit.Y - Ref.Y, DZ = Fit.Z - Ref.Z;
+				MaxError = std::max(MaxError, std::sqrt(DX * DX + DY * DY + DZ * DZ));
+			}
+		}
+		return MaxError;
+	}
+
+	/** Largest pitch or yaw difference in degrees between the keyed rotation and the exact aim at LookAt. */
+	inline double MaxLookAtError(const OrbitParams & P, const Vec3 & LookAt, const std::vector<RotationKey> & Keys, int SamplesPerSegment = 16)
+	{
+		double MaxError = 0.0;
+		for (size_t k = 0; k + 1 < Keys.size(); k++)
+		{
+			const RotationKey & A = Keys[k];
+			const RotationKey & B = Keys[k + 1];
+			const double H = B.T - A.T;
+			for (int s = 1; s < SamplesPerSegment; s++)
+			{
+				const double S = double(s) / double(SamplesPerSegment);
+				const double Pitch = EvaluateHermite(A.Pitch, A.PitchTangent, B.Pitch, B.PitchTangent, H, S);
+				const double Yaw = EvaluateHermite(A.Yaw, A.YawTangent, B.Yaw, B.YawTangent, H, S);
+
+				double RefPitch, RefYaw;
+				LookAtAngles(EvaluatePosition(P, A.T + H * S), LookAt, RefPitch, RefYaw);
+				MaxError = std::max(MaxError, std::fabs(Pitch - RefPitch));
+				MaxError = std::max(MaxError, std::fabs(UnwindDegrees(RefYaw, Yaw) - Yaw));
+			}
+		}
+		return MaxError;
+	}
+
+	/** Segment count predicted by the Hermite error bound. */
+	inline int EstimateSegments(const OrbitParams & P, double MaxError)
+	{
+		const double Radius = OrbitRadius(P);
+		const double Range = std::fabs(DegreesToRadians(P.EndAngle - P.StartAngle));
+		if (Radius <= 0.0 || Range <= 0.0 || MaxError <= 0.0) return 1;
+
+		const double Alpha = std::pow(384.0 * MaxError / Radius, 0.25);
+		return std::max(1, int(std::ceil(Range / Alpha)));
+	}
+
+	/** Fill Out with the fewest evenly spaced keys, up to MaxSegments + 1, that keep the orbit within MaxError. */
+	inline void FitOrbitKeys(const OrbitParams & P, double MaxError, std::vector<TangentKey> & Out, int MaxSegments = 1024)
+	{
+		for (int Segments = std::min(EstimateSegments(P, MaxError), MaxSegments); ; Segments++)
+		{
+			Out.clear();
+			Out.reserve(Segments + 1);
+			for (int k = 0; k <= Segments; k++)
+			{
+				const double T = double(k) / double(Segments);
+				Out.push_back(TangentKey{ T, EvaluatePosition(P, T), EvaluateTangent(P, T) });
+			}
+
+			if (Segments >= MaxSegments || MaxKeyError(P, Out) <= MaxError) break;
+		}
+	}
+
+	/**
+	 * Same as above for a camera aimed at LookAt: OutRotation gets its pitch and yaw at the same times, yaw unwound
+	 * from key to key, and keys are added until the rotation also stays within MaxAngleError degrees.
+	 */
+	inline void FitOrbitKeys(const OrbitParams & P, double MaxError, const Vec3 & LookAt, double MaxAngleError,
+		std::vector<TangentKey> & Out, std::vector<RotationKey> & OutRotation, int MaxSegments = 1024)
+	{
+		FitOrbitKeys(P, MaxError, Out, MaxSegments);
+
+		for (int Segments = int(Out.size()) - 1; ; )
+		{
+			OutRotation.clear();
+			OutRotation.reserve(Out.size());
+			for (const TangentKey & Key : Out)
+			{
+				RotationKey Rotation = EvaluateLookAt(P, LookAt, Key.T);
+				if (!OutRotation.empty()) Rotation.Yaw = UnwindDegrees(Rotation.Yaw, OutRotation.back().Yaw);
+				OutRotation.push_back(Rotation);
+			}
+
+			const double AngleError = MaxLookAtError(P, LookAt, OutRotation);
+			if (Segments >= MaxSegments || AngleError <= MaxAngleError) break;
+
+			// The Hermite error shrinks with the fourth power of the segment length
+			const double Scale = MaxAngleError > 0.0 ? std::pow(AngleError / MaxAngleError, 0.25) : 2.0;
+			Segments = std::min(MaxSegments, std::max(Segments + 1, int(std::ceil(Segments * Scale))));
+
+			Out.clear();
+			Out.reserve(Segments + 1);
+			for (int k = 0; k <= Segments; k++)
+			{
+				const double T = double(k) / double(Segments);
+				Out.push_back(TangentKey{ T, EvaluatePosition(P, T), EvaluateTangent(P, T) });
+			}
+		}
+	}
+}
@@ -0,0 +1,184 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Camera manifest: one fixed size record per rendered frame per camera, with the pose and
+// intrinsics of the camera at that frame, for dataset pipelines that never load Unreal.
+//
+// Layout, little endian:
+//   ManifestHeader
+//   ManifestRecord[NumRecords], camera after camera, frame after frame
+//   Target table at TargetTableOffset: uint32_t NameEnd[NumTargets], then the UTF-8 names back to back.
+//   Name t spans [NameEnd[t - 1], NameEnd[t]) of the text, ManifestRecord::Target indexes the table.
+//
+// Records are written straight from the orbit parameters or planned view paths, see
+// OrbitManifestReader.h to map a file.
+//
+// Version 2: shots may have different frame counts.
+// Version 3: FramesPerCamera is ManifestVariableFrames instead of 0 when they do, 0 is never valid.
+// Version 4: target name table, a manifest without cameras is valid.
+
+#include "OrbitTrajectory.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace OrbitCore
+{
+	constexpr char ManifestMagic[8] = { 'O', 'R', 'B', 'T', 'M', 'N', 'F', 'T' };
+	constexpr uint32_t ManifestVersion = 4;
+
+	/** FramesPerCamera of a manifest whose cameras have different frame counts. */
+	constexpr uint32_t ManifestVariableFrames = 0xFFFFFFFFu;
+
+#pragma pack(push, 4)
+	struct ManifestHeader
+	{
+		char Magic[8];
+		uint32_t Version;
+		uint32_t HeaderSize;     // Offset of the first record
+		uint32_t RecordSize;     // Stride between records
+		uint32_t NumCameras;
+		uint64_t NumRecords;
+		float FramesPerSecond;
+		uint32_t FramesPerCamera; // ManifestVariableFrames when cameras have different frame counts
+		uint32_t NumTargets;      // Entries of the target table
+		uint32_t TargetTableSize; // Bytes of the target table, name ends and text
+		uint64_t TargetTableOffset;
+	};
+
+	struct ManifestRecord
+	{
+		uint32_t Camera;         // Shot index in the sequence
+		uint32_t Target;         // Index of the target in the target table
+		int32_t Frame;           // Frame at FramesPerSecond from the start of the sequence
+		float Position[3];       // World space, cm
+		float Rotation[3];       // Pitch, yaw, roll in degrees, Unreal conventions
+		float FocalLength;       // mm
+		float Aperture;          // f-stop
+		float SensorWidth;       // mm
+		float SensorHeight;      // mm
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(ManifestHeader) == 56, "Manifest header layout changed, bump ManifestVersion");
+	static_assert(sizeof(ManifestRecord) == 52, "Manifest record layout changed, bump ManifestVersion");
+
+	/** Everything the records of one camera are computed from. */
+	struct ManifestCamera
+	{
+		uint32_t Target;
+		int32_t FirstFrame;      // Frame of the shot start from the start of the sequence
+		int NumFrames;
+		OrbitParams Orbit;
+		std::vector<Vec3> Path;  // One position per frame for planned shots, empty for orbits
+		Vec3 LookAt;             // World space point the camera aims at
+		float FocalLength;
+		float Aperture;
+		float SensorWidth;
+		float SensorHeight;
+	};
+
+	/** Record of camera Index at frame Frame of its shot. */
+	inline ManifestRecord MakeManifestRecord(const ManifestCamera & C, uint32_t Index, int Frame)
+	{
+		const double T = C.NumFrames > 0 ? double(Frame) / double(C.NumFrames) : 0.0;
+		const Vec3 P = C.Path.empty() ? EvaluatePosition(C.Orbit, T) : C.Path[std::min(size_t(Frame), C.Path.size() - 1)];
+		double Pitch, Yaw;
+		LookAtAngles(P, C.LookAt, Pitch, Yaw);
+
+		ManifestRecord R;
+		R.Camera = Index;
+		R.Target = C.Target;
+		R.Frame = C.FirstFrame + Frame;
+		R.Position[0] = float(P.X); R.Position[1] = float(P.Y); R.Position[2] = float(P.Z);
+		R.Rotation[0] = float(Pitch); R.Rotation[1] = float(Yaw); R.Rotation[2] = 0.0f;
+		R.FocalLength = C.FocalLength;
+		R.Aperture = C.Aperture;
+		R.SensorWidth = C.SensorWidth;
+		R.SensorHeight = C.SensorHeight;
+		return R;
+	}
+
+	/**
+	 * Write the manifest of the given cameras through Write(const void* Data, size_t Size), one call for
+	 * the header, one per camera and one for the target table. TargetNames is indexed by ManifestCamera::Target.
+	 */
+	template<typename WriteFunc>
+	void WriteManifest(const std::vector<ManifestCamera> & Cameras, const std::vector<std::string> & TargetNames, float FramesPerSecond, WriteFunc && Write)
+	{
+		uint64_t NumRecords = 0;
+		int FramesPerCamera = Cameras.empty() ? 0 : Cameras[0].NumFrames;
+		for (const ManifestCamera & C : Cameras)
+		{
+			NumRecords += uint64_t(std::max(C.NumFrames, 0));
+			if (C.NumFrames != FramesPerCamera) FramesPerCamera = 0;
+		}
+
+		// Name ends, then the names, so the reader finds any name without scanning the ones before it
+		std::vector<uint32_t> NameEnds;
+		std::string Names;
+		for (const std::string & Name : TargetNames)
+		{
+			Names += Name;
+			NameEnds.push_back(uint32_t(Names.size()));
+		}
+
+		ManifestHeader Header;
+		std::memcpy(Header.Magic, ManifestMagic, sizeof(Header.Magic));
+		Header.Version = ManifestVersion;
+		Header.HeaderSize = sizeof(ManifestHeader);
+		Header.RecordSize = sizeof(ManifestRecord);
+		Header.NumCameras = uint32_t(Cameras.size());
+		Header.NumRecords = NumRecords;
+		Header.FramesPerSecond = FramesPerSecond;
+		Header.FramesPerCamera = FramesPerCamera > 0 ? uint32_t(FramesPerCamera) : ManifestVariableFrames;
+		Header.NumTargets = uint32_t(NameEnds.size());
+		Header.TargetTableSize = uint32_t(NameEnds.size() * sizeof(uint32_t) + Names.size());
+		Header.TargetTableOffset = sizeof(ManifestHeader) + NumRecords * sizeof(ManifestRecord);
+		Write(&Header, sizeof(Header));
+
+		std::vector<ManifestRecord> Records;
+		for (size_t c = 0; c < Cameras.size(); c++)
+		{
+			Records.resize(std::max(Cameras[c].NumFrames, 0));
+			for (int f = 0; f < Cameras[c].NumFrames; f++)
+			{
+				Records[f] = MakeManifestRecord(Cameras[c], uint32_t(c), f);
+			}
+			if (!Records.empty()) Write(Records.data(), Records.size() * sizeof(ManifestRecord));
+		}
+
+		if (!NameEnds.empty()) Write(NameEnds.data(), NameEnds.size() * sizeof(uint32_t));
+		if (!Names.empty()) Write(Names.data(), Names.size());
+	}
+
+	/** Same records as WriteManifest as CSV text, TargetNames is indexed by ManifestCamera::Target. */
+	template<typename WriteFunc>
+	void WriteManifestCsv(const std::vector<ManifestCamera> & Cameras, const std::vector<std::string> & TargetNames, WriteFunc && Write)
+	{
+		const std::string HeaderLine = "Camera,Target,TargetName,Frame,X,Y,Z,Pitch,Yaw,Roll,FocalLength,Aperture,SensorWidth,SensorHeight\n";
+		Write(HeaderLine.data(), HeaderLine.size());
+
+		std::string Lines;
+		char Line[512];
+		for (size_t c = 0; c < Cameras.size(); c++)
+		{
+			const std::string & Name = Cameras[c].Target < TargetNames.size() ? TargetNames[Cameras[c].Target] : std::string();
+
+			Lines.clear();
+			for (int f = 0; f < Cameras[c].NumFrames; f++)
+			{
+				const ManifestRecord R = MakeManifestRecord(Cameras[c], uint32_t(c), f);
+				const int Length = std::snprintf(Line, sizeof(Line), "%u,%u,\"%s\",%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%g,%g,%g,%g\n",
+					R.Camera, R.Target, Name.c_str(), R.Frame,
+					R.Position[0], R.Position[1], R.Position[2], R.Rotation[0], R.Rotation[1], R.Rotation[2],
+					R.FocalLength, R.Aperture, R.SensorWidth, R.SensorHeight);
+				Lines.append(Line, std::min<size_t>(std::max(Length, 0), sizeof(Line) - 1));
+			}
+			Write(Lines.data(), Lines.size());
+		}
+	}
+}
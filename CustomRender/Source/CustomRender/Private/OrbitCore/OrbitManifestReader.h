@@ -0,0 +1,187 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Memory mapped access to a camera manifest written by OrbitManifest.h.
+// Meant for ingestion tools outside of Unreal, the editor module only writes manifests.
+
+#include "OrbitManifest.h"
+
+#if defined(_WIN32)
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace OrbitCore
+{
+	/** Read only view of a manifest file, records are used in place without copying. */
+	class ManifestReader
+	{
+	public:
+		ManifestReader() = default;
+		ManifestReader(const ManifestReader &) = delete;
+		ManifestReader & operator=(const ManifestReader &) = delete;
+		~ManifestReader() { Close(); }
+
+		/** Map the file and check its header, false if it can't be read or isn't a supported manifest. */
+		bool Open(const char * Path)
+		{
+			Close();
+			if (!Map(Path)) return false;
+
+			if (!IsValidHeader())
+			{
+				Close();
+				return false;
+			}
+			return true;
+		}
+
+		void Close()
+		{
+#if defined(_WIN32)
+			if (Data) UnmapViewOfFile(Data);
+#else
+			if (Data) munmap(const_cast<unsigned char *>(Data), Size);
+#endif
+			Data = nullptr;
+			Size = 0;
+		}
+
+		bool IsOpen() const { return Data != nullptr; }
+
+		const ManifestHeader & Header() const { return *reinterpret_cast<const ManifestHeader *>(Data); }
+
+		size_t Num() const { return IsOpen() ? size_t(Header().NumRecords) : 0; }
+
+		/** Record Index, the stride comes from the header so newer writers may append fields. */
+		const ManifestRecord & operator[](size_t Index) const
+		{
+			return *reinterpret_cast<const ManifestRecord *>(Data + Header().HeaderSize + Index * Header().RecordSize);
+		}
+
+		/** Record of a camera at a frame of its shot, nullptr when the camera or the frame isn't in the manifest. */
+		const ManifestRecord * At(uint32_t Camera, uint32_t Frame) const
+		{
+			if (!IsOpen() || Camera >= Header().NumCameras) return nullptr;
+
+			const uint64_t NumRecords = Header().NumRecords;
+			const uint32_t FramesPerCamera = Header().FramesPerCamera;
+			if (FramesPerCamera != ManifestVariableFrames)
+			{
+				return Frame < FramesPerCamera ? &(*this)[size_t(uint64_t(Camera) * FramesPerCamera + Frame)] : nullptr;
+			}
+
+			// Records are written camera after camera, the first record of the camera is found by bisection
+			uint64_t First = 0, Last = NumRecords;
+			while (First < Last)
+			{
+				const uint64_t Middle = First + (Last - First) / 2;
+				if ((*this)[size_t(Middle)].Camera < Camera) First = Middle + 1;
+				else Last = Middle;
+			}
+
+			if (Frame >= NumRecords - First) return nullptr;
+			const ManifestRecord & Record = (*this)[size_t(First + Frame)];
+			return Record.Camera == Camera ? &Record : nullptr;
+		}
+
+		/** Name of a target from the target table, empty when Target isn't in it. */
+		std::string TargetName(uint32_t Target) const
+		{
+			if (!IsOpen() || Target >= Header().NumTargets) return std::string();
+
+			const unsigned char * Table = Data + Header().TargetTableOffset;
+			const char * Text = reinterpret_cast<const char *>(Table + size_t(Header().NumTargets) * sizeof(uint32_t));
+			const uint32_t Begin = Target > 0 ? NameEnd(Target - 1) : 0;
+			return std::string(Text + Begin, NameEnd(Target) - Begin);
+		}
+
+	private:
+		uint32_t NameEnd(uint32_t Target) const
+		{
+			uint32_t End;
+			std::memcpy(&End, Data + Header().TargetTableOffset + size_t(Target) * sizeof(uint32_t), sizeof(End));
+			return End;
+		}
+
+		/**
+		 * Header checks in 64 bits, without a multiplication that could wrap, so no field of a truncated or
+		 * corrupted file can make a record reach past the end of the mapping.
+		 */
+		bool IsValidHeader() const
+		{
+			if (Size < sizeof(ManifestHeader)) return false;
+
+			const ManifestHeader & H = Header();
+			if (std::memcmp(H.Magic, ManifestMagic, sizeof(ManifestMagic)) != 0 || H.Version != ManifestVersion) return false;
+
+			// Records are read in place, their offsets have to keep the fields aligned
+			if (H.HeaderSize < sizeof(ManifestHeader) || H.RecordSize < sizeof(ManifestRecord)) return false;
+			if (H.HeaderSize % alignof(ManifestRecord) != 0 || H.RecordSize % alignof(ManifestRecord) != 0) return false;
+
+			const uint64_t FileSize = uint64_t(Size);
+			if (H.HeaderSize > FileSize || H.NumRecords > (FileSize - H.HeaderSize) / H.RecordSize) return false;
+
+			// A run without shots writes a manifest without cameras, and then without records
+			if (H.FramesPerCamera == 0 || (H.NumCameras == 0 && H.NumRecords != 0)) return false;
+			if (H.FramesPerCamera != ManifestVariableFrames && uint64_t(H.NumCameras) * H.FramesPerCamera != H.NumRecords) return false;
+
+			// The name ends have to stay ascending and within the text, so TargetName never reads past the table
+			const uint64_t EndsSize = uint64_t(H.NumTargets) * sizeof(uint32_t);
+			if (H.TargetTableOffset > FileSize || H.TargetTableSize > FileSize - H.TargetTableOffset || EndsSize > H.TargetTableSize) return false;
+			uint32_t Previous = 0;
+			for (uint32_t t = 0; t < H.NumTargets; t++)
+			{
+				const uint32_t End = NameEnd(t);
+				if (End < Previous || End > H.TargetTableSize - EndsSize) return false;
+				Previous = End;
+			}
+			return true;
+		}
+
+	private:
+		bool Map(const char * Path)
+		{
+#if defined(_WIN32)
+			HANDLE File = CreateFileA(Path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (File == INVALID_HANDLE_VALUE) return false;
+
+			LARGE_INTEGER FileSize;
+			HANDLE Mapping = GetFileSizeEx(File, &FileSize) && FileSize.QuadPart > 0 ? CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+			CloseHandle(File);
+			if (!Mapping) return false;
+
+			Data = static_cast<const unsigned char *>(MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0));
+			CloseHandle(Mapping);
+			Size = Data ? size_t(FileSize.QuadPart) : 0;
+#else
+			const int File = open(Path, O_RDONLY);
+			if (File < 0) return false;
+
+			struct stat Stat;
+			if (fstat(File, &Stat) == 0 && Stat.st_size > 0)
+			{
+				void * Mapped = mmap(nullptr, size_t(Stat.st_size), PROT_READ, MAP_SHARED, File, 0);
+				if (Mapped != MAP_FAILED)
+				{
+					Data = static_cast<const unsigned char *>(Mapped);
+					Size = size_t(Stat.st_size);
+				}
+			}
+			close(File);
+#endif
+			return Data != nullptr;
+		}
+
+		const unsigned char * Data = nullptr;
+		size_t Size = 0;
+	};
+}
@@ -0,0 +1,103 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Orbit trajectory math shared by the editor module and offline tools.
+// Plain C++ only: no engine types, so it builds and runs outside of Unreal.
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+namespace OrbitCore
+{
+	struct Vec3
+	{
+		double X, Y, Z;
+	};
+
+	/** Everything one orbit is generated from, angles in degrees like the editor settings. */
+	struct OrbitParams
+	{
+		Vec3 Origin;             // Center the camera flies around
+		Vec3 Extent;             // Bounds box extent of the target
+		double RadiusMultiplier;
+		double CameraHeight;     // Absolute camera height
+		double StartAngle;
+		double EndAngle;
+	};
+
+	/** A position on the orbit, T is the normalized time in the shot [0, 1]. */
+	struct OrbitKey
+	{
+		double T;
+		Vec3 Position;
+	};
+
+	constexpr double Pi = 3.14159265358979323846;
+
+	inline double DegreesToRadians(double Degrees) { return Degrees * (Pi / 180.0); }
+
+	inline double OrbitRadius(const OrbitParams & P)
+	{
+		return std::max(P.Extent.X, P.Extent.Y) * P.RadiusMultiplier;
+	}
+
+	/** Distance the camera travels along the orbit. */
+	inline double ArcLength(const OrbitParams & P)
+	{
+		return OrbitRadius(P) * std::fabs(DegreesToRadians(P.EndAngle - P.StartAngle));
+	}
+
+	/**
+	 * Shortest shot length in seconds that keeps the camera under LinearSpeed (cm/s) and AngularSpeed (deg/s),
+	 * clamped to [MinSeconds, MaxSeconds]. A speed of 0 puts no limit on the shot.
+	 */
+	inline double ShotSeconds(const OrbitParams & P, double LinearSpeed, double AngularSpeed, double MinSeconds, double MaxSeconds)
+	{
+		double Seconds = 0.0;
+		if (LinearSpeed > 0.0) Seconds = std::max(Seconds, ArcLength(P) / LinearSpeed);
+		if (AngularSpeed > 0.0) Seconds = std::max(Seconds, std::fabs(P.EndAngle - P.StartAngle) / AngularSpeed);
+		return std::min(std::max(Seconds, MinSeconds), std::max(MinSeconds, MaxSeconds));
+	}
+
+	/** Normalized time of key Index out of NumKeys, keys span the whole shot. */
+	inline double KeyTime(int Index, int NumKeys)
+	{
+		return NumKeys > 1 ? double(Index) / double(NumKeys - 1) : 0.0;
+	}
+
+	/** Frame of a normalized time in a shot that starts at StartFrame and lasts DurationFrames. */
+	inline int KeyFrame(double T, int StartFrame, int DurationFrames)
+	{
+		return StartFrame + int(T * DurationFrames);
+	}
+
+	/** Camera position at normalized time T, the angle is interpolated linearly around the Z axis. */
+	inline Vec3 EvaluatePosition(const OrbitParams & P, double T)
+	{
+		const double Radius = OrbitRadius(P);
+		const double Theta = DegreesToRadians(P.StartAngle + T * (P.EndAngle - P.StartAngle));
+		return Vec3{ P.Origin.X + Radius * std::cos(Theta), P.Origin.Y + Radius * std::sin(Theta), P.CameraHeight };
+	}
+
+	/** Pitch and yaw in degrees of a camera at From looking at To, like FVector::Rotation. */
+	inline void LookAtAngles(const Vec3 & From, const Vec3 & To, double & Pitch, double & Yaw)
+	{
+		const double DX = To.X - From.X, DY = To.Y - From.Y, DZ = To.Z - From.Z;
+		Yaw = std::atan2(DY, DX) * (180.0 / Pi);
+		Pitch = std::atan2(DZ, std::sqrt(DX * DX + DY * DY)) * (180.0 / Pi);
+	}
+
+	/** Fill Out with NumKeys evenly timed positions along the orbit. */
+	inline void GenerateKeys(const OrbitParams & P, int NumKeys, std::vector<OrbitKey> & Out)
+	{
+		Out.clear();
+		Out.reserve(std::max(NumKeys, 0));
+		for (int i = 0; i < NumKeys; i++)
+		{
+			const double T = KeyTime(i, NumKeys);
+			Out.push_back(OrbitKey{ T, EvaluatePosition(P, T) });
+		}
+	}
+}
@@ -0,0 +1,137 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// How much of its target an orbit actually sees.
+// Rays go from evenly spaced positions on the orbit to the center and the corners of the target's
+// bounds, scaled in a little so they land on the object rather than next to it. Whoever casts the rays
+// reports which ones reached the target; this file turns that into per position and per orbit
+// visibility, alternative orbits to try, and the longest visible arc of an orbit.
+
+#include "OrbitTrajectory.h"
+
+#include <cstdint>
+
+namespace OrbitCore
+{
+	struct VisibilityRay
+	{
+		Vec3 Start;
+		Vec3 End;
+	};
+
+	struct VisibilityParams
+	{
+		int NumPositions = 16;        // Positions tested along each orbit
+		double PointScale = 0.8;      // Target points sit on the bounds scaled by this
+		double MinVisibility = 0.6;   // Share of rays that must reach the target
+	};
+
+	/** Center and corners of the bounds */
+	constexpr int NumTargetPoints = 9;
+
+	inline int RaysPerOrbit(const VisibilityParams & V)
+	{
+		return V.NumPositions * NumTargetPoints;
+	}
+
+	/** Write the RaysPerOrbit rays of one orbit to Out, position major: NumTargetPoints consecutive rays per position. */
+	inline void WriteVisibilityRays(const OrbitParams & P, const VisibilityParams & V, VisibilityRay * Out)
+	{
+		Vec3 Points[NumTargetPoints];
+		Points[0] = P.Origin;
+		for (int c = 0; c < 8; c++)
+		{
+			Points[c + 1] = Vec3{
+				P.Origin.X + ((c & 1) ? 1 : -1) * P.Extent.X * V.PointScale,
+				P.Origin.Y + ((c & 2) ? 1 : -1) * P.Extent.Y * V.PointScale,
+				P.Origin.Z + ((c & 4) ? 1 : -1) * P.Extent.Z * V.PointScale };
+		}
+
+		for (int k = 0; k < V.NumPositions; k++)
+		{
+			const Vec3 Position = EvaluatePosition(P, KeyTime(k, V.NumPositions));
+			for (const Vec3 & Point : Points)
+			{
+				*Out++ = VisibilityRay{ Position, Point };
+			}
+		}
+	}
+
+	/** Share of visible rays at every position of one orbit, Visible holds RaysPerOrbit entries. */
+	inline void PositionVisibility(const uint8_t * Visible, const VisibilityParams & V, std::vector<double> & Out)
+	{
+		Out.assign(V.NumPositions, 0.0);
+		for (int k = 0; k < V.NumPositions; k++)
+		{
+			int Count = 0;
+			for (int p = 0; p < NumTargetPoints; p++) Count += Visible[k * NumTargetPoints + p] ? 1 : 0;
+			Out[k] = double(Count) / NumTargetPoints;
+		}
+	}
+
+	inline double MeanVisibility(const std::vector<double> & PerPosition)
+	{
+		double Sum = 0.0;
+		for (double V : PerPosition) Sum += V;
+		return PerPosition.empty() ? 0.0 : Sum / PerPosition.size();
+	}
+
+	/**
+	 * Orbits to try when P is occluded, P first. The camera goes up by half and by all of the orbit radius,
+	 * and comes closer or moves away by a quarter, alone and combined with the smaller raise.
+	 */
+	inline std::vector<OrbitParams> CandidateOrbits(const OrbitParams & P)
+	{
+		const double Radius = OrbitRadius(P);
+		const double Raises[] = { 0.0, 0.5 * Radius, Radius };
+		const double Scales[] = { 1.0, 0.75, 1.25 };
+
+		std::vector<OrbitParams> Candidates;
+		for (double Raise : Raises)
+		{
+			for (double Scale : Scales)
+			{
+				if (Raise == Radius && Scale != 1.0) continue;
+
+				OrbitParams C = P;
+				C.CameraHeight += Raise;
+				C.RadiusMultiplier *= Scale;
+				Candidates.push_back(C);
+			}
+		}
+		return Candidates;
+	}
+
+	/**
+	 * Shrink P to the longest run of consecutive positions that are at least MinVisibility visible.
+	 * @return false when no run spans two positions
+	 */
+	inline bool TrimToVisibleArc(const OrbitParams & P, const std::vector<double> & PerPosition, double MinVisibility, OrbitParams & Out, double & OutVisibility)
+	{
+		const int Num = int(PerPosition.size());
+		int BestFirst = 0, BestCount = 0;
+		for (int First = 0; First < Num; )
+		{
+			if (PerPosition[First] < MinVisibility) { First++; continue; }
+
+			int Last = First;
+			while (Last + 1 < Num && PerPosition[Last + 1] >= MinVisibility) Last++;
+			if (Last - First + 1 > BestCount)
+			{
+				BestFirst = First;
+				BestCount = Last - First + 1;
+			}
+			First = Last + 1;
+		}
+		if (BestCount < 2) return false;
+
+		const double Range = P.EndAngle - P.StartAngle;
+		Out = P;
+		Out.StartAngle = P.StartAngle + KeyTime(BestFirst, Num) * Range;
+		Out.EndAngle = P.StartAngle + KeyTime(BestFirst + BestCount - 1, Num) * Range;
+
+		OutVisibility = MeanVisibility(std::vector<double>(PerPosition.begin() + BestFirst, PerPosition.begin() + BestFirst + BestCount));
+		return true;
+	}
+}
@@ -0,0 +1,158 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "SCustomRenderActorList.h"
+#include "GameFramework/Actor.h"
+#include "Widgets/SBoxPanel.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Input/SSpinBox.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/Input/SSearchBox.h"
+#include "Widgets/Views/STableRow.h"
+
+void SCustomRenderActorList::Construct(const FArguments& InArgs)
+{
+	Settings = InArgs._Settings;
+	check(Settings);
+
+	AllRows.Reserve(Settings->Actors.Num());
+	for (int32 i = 0; i < Settings->Actors.Num(); i++)
+	{
+		AllRows.Add(MakeShareable(new FCustomRenderActorRow{ i, Settings->Actors[i].Target.GetLabel() }));
+	}
+	FilteredRows = AllRows;
+
+	auto HeaderText = [](const TCHAR* Text) { return SNew(STextBlock).Text(FText::FromString(Text)); };
+
+	ChildSlot
+	[
+		SNew(SVerticalBox)
+		+ SVerticalBox::Slot().AutoHeight().Padding(10).HAlign(HAlign_Center)
+		[
+			SNew(STextBlock).Text(FText::FromString("Per Object Settings"))
+		]
+		+ SVerticalBox::Slot().AutoHeight().Padding(2)
+		[
+			SNew(SSearchBox)
+			.HintText(FText::FromString("Filter objects"))
+			.OnTextChanged(this, &SCustomRenderActorList::OnFilterTextChanged)
+		]
+		+ SVerticalBox::Slot().AutoHeight()
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f).HAlign(HAlign_Center)[HeaderText(TEXT(" "))]
+			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.4f).HAlign(HAlign_Center)[HeaderText(TEXT("Object"))]
+			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f).HAlign(HAlign_Center)[HeaderText(TEXT("CH"))]
+			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f).HAlign(HAlign_Center)[HeaderText(TEXT("R"))]
+			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f).HAlign(HAlign_Center)[HeaderText(TEXT("LH"))]
+			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f).HAlign(HAlign_Center)[HeaderText(TEXT("SA"))]
+			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f).HAlign(HAlign_Center)[HeaderText(TEXT("EA"))]
+			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f).HAlign(HAlign_Center)[HeaderText(TEXT("FP"))]
+			+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f).HAlign(HAlign_Center)[HeaderText(TEXT("CP"))]
+		]
+		+ SVerticalBox::Slot().AutoHeight()
+		[
+			MakeRowContent([this]() { return &BulkSettings; },
+				SNew(SButton)
+				.Text(FText::FromString("Apply to selected"))
+				.ToolTipText(FText::FromString("Copy these values to the selected objects, or to every listed object when none is selected"))
+				.OnClicked(this, &SCustomRenderActorList::OnApplyBulkEdit))
+		]
+		+ SVerticalBox::Slot().FillHeight(1.0f)
+		[
+			SAssignNew(ListView, SListView<TSharedPtr<FCustomRenderActorRow>>)
+			.ListItemsSource(&FilteredRows)
+			.SelectionMode(ESelectionMode::Multi)
+			.OnGenerateRow(this, &SCustomRenderActorList::OnGenerateRow)
+		]
+	];
+}
+
+TSharedRef<ITableRow> SCustomRenderActorList::OnGenerateRow(TSharedPtr<FCustomRenderActorRow> Row, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	FCustomRenderSettings* InSettings = Settings;
+	const int32 Index = Row->Index;
+	auto GetEntry = [InSettings, Index]() { return InSettings->Actors.IsValidIndex(Index) ? &InSettings->Actors[Index] : nullptr; };
+
+	return SNew(STableRow<TSharedPtr<FCustomRenderActorRow>>, OwnerTable)
+	[
+		MakeRowContent(GetEntry, SNew(STextBlock).Text(FText::FromString(Row->Label)))
+	];
+}
+
+TSharedRef<SWidget> SCustomRenderActorList::MakeRowContent(TFunction<FCustomRenderActorSettings*()> GetEntry, TSharedRef<SWidget> LabelWidget)
+{
+	return SNew(SHorizontalBox)
+		+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f)[MakeBoolEditor(GetEntry, &FCustomRenderActorSettings::bIsEnabled)]
+		+ SHorizontalBox::Slot().Padding(2).FillWidth(0.4f)[LabelWidget]
+		+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f)[MakeFloatEditor(GetEntry, &FCustomRenderActorSettings::CameraHeight, -1000.0f, 1000.0f)]
+		+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f)[MakeFloatEditor(GetEntry, &FCustomRenderActorSettings::Radius, 0.0f, 20.0f)]
+		+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f)[MakeFloatEditor(GetEntry, &FCustomRenderActorSettings::LookatHeightAdjust, -20.0f, 20.0f)]
+		+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f)[MakeFloatEditor(GetEntry, &FCustomRenderActorSettings::StartAngle, -360.0f, 720.0f)]
+		+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f)[MakeFloatEditor(GetEntry, &FCustomRenderActorSettings::EndAngle, -360.0f, 720.0f)]
+		+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f)[MakeBoolEditor(GetEntry, &FCustomRenderActorSettings::bFixPivot)]
+		+ SHorizontalBox::Slot().Padding(2).FillWidth(0.1f)[MakeBoolEditor(GetEntry, &FCustomRenderActorSettings::bCenterPivot)];
+}
+
+TSharedRef<SWidget> SCustomRenderActorList::MakeFloatEditor(TFunction<FCustomRenderActorSettings*()> GetEntry, float FCustomRenderActorSettings::* Field, float MinValue, float MaxValue)
+{
+	return SNew(SSpinBox<float>)
+		.MinValue(MinValue)
+		.MaxValue(MaxValue)
+		.Value_Lambda([GetEntry, Field]() {
+			FCustomRenderActorSettings* Entry = GetEntry();
+			return Entry ? Entry->*Field : FCustomRenderActorSettings().*Field;
+		})
+		.OnValueChanged_Lambda([GetEntry, Field](float Value) {
+			if (FCustomRenderActorSettings* Entry = GetEntry()) Entry->*Field = Value;
+		});
+}
+
+TSharedRef<SWidget> SCustomRenderActorList::MakeBoolEditor(TFunction<FCustomRenderActorSettings*()> GetEntry, bool FCustomRenderActorSettings::* Field)
+{
+	return SNew(SCheckBox)
+		.IsChecked_Lambda([GetEntry, Field]() {
+			FCustomRenderActorSettings* Entry = GetEntry();
+			return Entry && Entry->*Field ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+		})
+		.OnCheckStateChanged_Lambda([GetEntry, Field](ECheckBoxState State) {
+			if (FCustomRenderActorSettings* Entry = GetEntry()) Entry->*Field = State == ECheckBoxState::Checked;
+		});
+}
+
+void SCustomRenderActorList::OnFilterTextChanged(const FText& InFilterText)
+{
+	const FString Filter = InFilterText.ToString();
+
+	FilteredRows.Reset();
+	for (const auto& Row : AllRows)
+	{
+		if (Filter.IsEmpty() || Row->Label.Contains(Filter))
+		{
+			FilteredRows.Add(Row);
+		}
+	}
+
+	ListView->RequestListRefresh();
+}
+
+FReply SCustomRenderActorList::OnApplyBulkEdit()
+{
+	TArray<TSharedPtr<FCustomRenderActorRow>> Rows = ListView->GetSelectedItems();
+	if (Rows.Num() == 0)
+	{
+		Rows = FilteredRows;
+	}
+
+	for (const auto& Row : Rows)
+	{
+		if (!Settings->Actors.IsValidIndex(Row->Index)) continue;
+
+		FCustomRenderActorSettings& Entry = Settings->Actors[Row->Index];
+		const FCustomRenderTarget Target = Entry.Target;
+		Entry = BulkSettings;
+		Entry.Target = Target;
+	}
+
+	return FReply::Handled();
+}
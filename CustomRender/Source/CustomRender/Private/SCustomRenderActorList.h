@@ -0,0 +1,63 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+#include "CustomRenderSettings.h"
+
+class ITableRow;
+class STableViewBase;
+
+/** One row of the per object list, the index of its entry in FCustomRenderSettings::Actors. */
+struct FCustomRenderActorRow
+{
+	int32 Index;
+	FString Label;
+};
+
+/**
+ * Per object settings of the selection as a virtualized list: only the visible rows have widgets,
+ * so opening and scrolling cost the same for ten or ten thousand actors. Every row edits the
+ * settings entry it is bound to. Rows can be filtered by label and edited in bulk.
+ */
+class SCustomRenderActorList : public SCompoundWidget
+{
+public:
+
+	SLATE_BEGIN_ARGS(SCustomRenderActorList) {}
+		/** Settings edited by the list, must outlive it */
+		SLATE_ARGUMENT(FCustomRenderSettings*, Settings)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+private:
+
+	TSharedRef<ITableRow> OnGenerateRow(TSharedPtr<FCustomRenderActorRow> Row, const TSharedRef<STableViewBase>& OwnerTable);
+
+	void OnFilterTextChanged(const FText& InFilterText);
+
+	/** Copy the bulk edit values to the selected rows, or to every listed row when nothing is selected */
+	FReply OnApplyBulkEdit();
+
+	/** Editors for one field of the settings returned by GetEntry, nullptr entries show defaults */
+	static TSharedRef<SWidget> MakeFloatEditor(TFunction<FCustomRenderActorSettings*()> GetEntry, float FCustomRenderActorSettings::* Field, float MinValue, float MaxValue);
+	static TSharedRef<SWidget> MakeBoolEditor(TFunction<FCustomRenderActorSettings*()> GetEntry, bool FCustomRenderActorSettings::* Field);
+
+	/** Row layout shared by the header, the bulk edit row and the actor rows */
+	static TSharedRef<SWidget> MakeRowContent(TFunction<FCustomRenderActorSettings*()> GetEntry, TSharedRef<SWidget> LabelWidget);
+
+private:
+
+	FCustomRenderSettings* Settings = nullptr;
+
+	/** Values applied to many rows at once */
+	FCustomRenderActorSettings BulkSettings;
+
+	TArray<TSharedPtr<FCustomRenderActorRow>> AllRows;
+	TArray<TSharedPtr<FCustomRenderActorRow>> FilteredRows;
+
+	TSharedPtr<SListView<TSharedPtr<FCustomRenderActorRow>>> ListView;
+};
@@ -4,11 +4,47 @@
 
 #include "CoreMinimal.h"
 #include "ModuleManager.h"
+#include "EditorUndoClient.h"
+#include "CustomRenderSettings.h"
 
 class FToolBarBuilder;
 class FMenuBuilder;
+class ACineCameraActor;
+class UWorld;
+class ULevelSequence;
+class UMovieSceneCameraCutSection;
+class UMovieScene3DTransformSection;
+struct FTransactionContext;
 
-class FCustomRenderModule : public IModuleInterface
+/** What the Master sequence holds for one shot, so a later run can regenerate only what changed. */
+struct FCustomRenderShotRecord
+{
+	/** Target the camera is set up for, the first of Members */
+	FCustomRenderTarget Target;
+
+	/** Every target the shot covers, more than one when nearby targets were clustered */
+	TArray<FCustomRenderTarget> Members;
+
+	TWeakObjectPtr<ACineCameraActor> Camera;
+	TWeakObjectPtr<UMovieSceneCameraCutSection> CutSection;
+	TWeakObjectPtr<UMovieScene3DTransformSection> MoveSection;
+	FGuid CameraGuid;
+
+	/** Sequence the camera is bound in, Master or one of its shards */
+	TWeakObjectPtr<ULevelSequence> Sequence;
+	int32 Shard = INDEX_NONE;
+
+	/** Share of visibility rays that reached the target from the keyed orbit, 1 when not checked */
+	float Visibility = 1.0f;
+
+	/** Hash of everything the camera and its keys were generated from, except where the shot starts */
+	uint32 Hash = 0;
+
+	/** Frame the keys were written from, the keys are shifted when only the start of the shot changes */
+	int32 StartFrame = 0;
+};
+
+class FCustomRenderModule : public IModuleInterface, public FEditorUndoClient
 {
 public:
 
@@ -21,11 +57,64 @@ public:
 	
 	void CreateSequence();
 
+	/**
+	 * Generate or update the Master sequence for the given targets without any UI.
+	 * settings.Actors holds one entry per target, in the same order.
+	 * @return The Master sequence, nullptr if it could not be created or the run was
+	 * cancelled before anything changed. A run cancelled later keeps its partial shots, the next
+	 * incremental run completes them.
+	 */
+	ULevelSequence* GenerateSequence(UWorld* world, const TArray<FCustomRenderTarget>& targets, const FCustomRenderSettings& settings);
+
+	/** Same as above with one target per actor */
+	ULevelSequence* GenerateSequence(UWorld* world, const TArray<AActor*>& targets, const FCustomRenderSettings& settings);
+
+	/** Destroy every camera the plugin spawned in the level, pooled or not, so the next run spawns all of its cameras again */
+	void DestroyCameras(UWorld* world);
+
+	/** Actor tag of every camera spawned by the plugin */
+	static const FName CameraTag;
+
+	/** FEditorUndoClient implementation */
+	virtual void PostUndo(bool bSuccess) override;
+	virtual void PostRedo(bool bSuccess) override;
+
 private:
 
 	void AddToolbarExtension(FToolBarBuilder& Builder);
 	void AddMenuExtension(FMenuBuilder& Builder);
 
+	/** Forget the shot records when the undone or redone transaction is a generation run */
+	void OnGenerationUndoRedo(const FTransactionContext& context);
+
+	/** Take a camera for the target from the pool, spawn one if the pool has none left */
+	ACineCameraActor* AcquireCamera(UWorld* world, const FCustomRenderTarget& target);
+
+	/** Hide the camera and keep it in the pool, keyed by the target it was set up for */
+	void ReleaseCamera(ACineCameraActor* camera, const FCustomRenderTarget& target);
+
+	/** Destroy the pooled cameras of the level, once a run has taken the ones it needs */
+	void TrimCameraPool(UWorld* world);
+
+	/** Cameras the plugin spawned in the level, the level is scanned for tagged cameras the first time it is seen */
+	TArray<TWeakObjectPtr<ACineCameraActor>>& FindOwnedCameras(UWorld* world);
+
 private:
 	TSharedPtr<class FUICommandList> PluginCommands;
+
+	/** Global and per object settings of the current selection */
+	FCustomRenderSettings Settings;
+
+	/** Shard the settings window's Rebuild Shard button regenerates */
+	int32 ShardToRebuild = 0;
+
+	/** Cameras spawned by the plugin per level, also marked with an actor tag so they survive an editor restart */
+	TMap<TWeakObjectPtr<UWorld>, TArray<TWeakObjectPtr<ACineCameraActor>>> OwnedCameras;
+
+	/** Owned cameras no shot uses, reused by later runs instead of being destroyed and spawned again */
+	TMultiMap<FCustomRenderTarget, TWeakObjectPtr<ACineCameraActor>> PooledCameras;
+
+	/** Shots of the last generated Master sequence, in camera cut order */
+	TArray<FCustomRenderShotRecord> ShotRecords;
+	TWeakObjectPtr<ULevelSequence> MasterSequence;
 };
\ No newline at end of file
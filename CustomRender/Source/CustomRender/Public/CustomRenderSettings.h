@@ -0,0 +1,246 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+#include "CustomRenderTarget.h"
+
+class AActor;
+
+/** Camera settings shared by every generated shot. */
+struct FCustomRenderGlobalSettings
+{
+	float Aperture = 1.8f;
+	float FocalLength = 4.0f;
+	float CameraHeight = 150.0f;
+	float RadiusMultiplier = 3.0f;
+	float StartAngle = 0.0f;
+	float EndAngle = 180.0f;
+
+	/** Height of the look at point above the pivot, in half heights of the bounds. A cluster's pivot is the middle of its combined bounds. */
+	float LookatHeightAdjust = 0.5f;
+	float FPS = 30.0f;
+	bool bFixPivot = false;
+	bool bCenterPivot = false;
+
+	/** Update the existing Master sequence in place instead of rebuilding it */
+	bool bIncremental = true;
+
+	/**
+	 * Key each orbit with as few cubic keys as MaxKeyError (cm) allows instead of FPS keys.
+	 * With bBakeLookAt the rotation keys also stay within MaxAngleError (degrees) of the exact aim.
+	 */
+	bool bMinimalKeys = false;
+	float MaxKeyError = 0.1f;
+	float MaxAngleError = 0.05f;
+
+	/** Key the camera rotation toward the look at point instead of tracking it every tick */
+	bool bBakeLookAt = false;
+
+	/** Write per frame camera poses and intrinsics to Saved/CustomRender, optionally as CSV too */
+	bool bWriteManifest = false;
+	bool bWriteManifestCsv = false;
+
+	/**
+	 * Replace the orbits with the fewest views, one frame each, that see TargetCoverage of the
+	 * directions between MinElevation and MaxElevation (degrees). A view covers CoverageViewAngle degrees
+	 * around its direction. Views sit at the orbit radius from the target's origin.
+	 */
+	bool bCoveragePlanner = false;
+	float CoverageViewAngle = 25.0f;
+	float TargetCoverage = 0.95f;
+	float MinElevation = 0.0f;
+	float MaxElevation = 60.0f;
+
+	/**
+	 * Time each orbit so the camera moves no faster than CameraSpeed (cm/s) and AngularSpeed (deg/s)
+	 * instead of one second per shot, clamped to [MinShotSeconds, MaxShotSeconds]. Dense keys follow at FPS.
+	 */
+	bool bAdaptiveDuration = false;
+	float CameraSpeed = 500.0f;
+	float AngularSpeed = 90.0f;
+	float MinShotSeconds = 0.5f;
+	float MaxShotSeconds = 10.0f;
+
+	/**
+	 * Cover targets closer than ClusterGap (cm) to each other with a single orbit around their combined
+	 * bounds, as long as those stay under MaxClusterSize (cm). Larger targets keep a shot of their own.
+	 */
+	bool bClusterTargets = false;
+	float ClusterGap = 50.0f;
+	float MaxClusterSize = 300.0f;
+
+	/**
+	 * Split the shots into child sequences of ShardSize shots each, played back to back by Master through
+	 * a subsequence track. Every shard can be opened and rendered on its own. 0 keeps every shot in Master.
+	 * An incremental run only rebuilds the shots whose hash changed or that moved to another shard, so only
+	 * their shards are touched. That relies on the shot records of the editor session: the first run after
+	 * a restart or after undoing a generation run rebuilds every shard.
+	 */
+	int32 ShardSize = 0;
+
+	/**
+	 * Rebuild every shot of this shard from scratch, bindings included, and leave Master's other shards as they are.
+	 * The shots are read back from the shard's camera cuts when the editor session has no records of them, so this
+	 * also works after a restart, as long as the selection still splits into as many shards. INDEX_NONE runs as usual.
+	 */
+	int32 RebuildShard = INDEX_NONE;
+
+	/**
+	 * Trace from VisibilitySamples positions of every orbit to its target. With bAdjustOccluded, orbits that see
+	 * less than MinVisibility of their rays through move up, closer or farther, or are trimmed to their visible arc.
+	 * Visibility is reported per shot either way. Planned views are not checked.
+	 */
+	bool bCheckVisibility = false;
+	bool bAdjustOccluded = true;
+	int32 VisibilitySamples = 16;
+	float MinVisibility = 0.6f;
+};
+
+/** Per object overrides. Height, radius, look at and angles only apply when bIsEnabled is set. */
+struct FCustomRenderActorSettings
+{
+	FCustomRenderTarget Target;
+
+	bool bIsEnabled = false;
+	float CameraHeight = 0.0f;
+	float Radius = 1.0f;
+	float LookatHeightAdjust = 1.0f;
+	float StartAngle = 0.0f;
+	float EndAngle = 180.0f;
+	bool bFixPivot = false;
+	bool bCenterPivot = false;
+};
+
+/** Effective values of a single shot, resolved once before any camera or key is created. */
+struct FCustomRenderShotSettings
+{
+	float CameraHeight;
+	float RadiusMultiplier;
+	float LookatHeightAdjust;
+	float StartAngle;
+	float EndAngle;
+	bool bFixPivot;
+	bool bCenterPivot;
+
+	static FCustomRenderShotSettings Resolve(const FCustomRenderGlobalSettings& Global, const FCustomRenderActorSettings& Actor)
+	{
+		FCustomRenderShotSettings Shot;
+		Shot.CameraHeight = Actor.bIsEnabled ? Actor.CameraHeight + Global.CameraHeight : Global.CameraHeight;
+		Shot.RadiusMultiplier = Actor.bIsEnabled ? Actor.Radius * Global.RadiusMultiplier : Global.RadiusMultiplier;
+		Shot.LookatHeightAdjust = Actor.bIsEnabled ? Actor.LookatHeightAdjust * Global.LookatHeightAdjust : Global.LookatHeightAdjust;
+		Shot.StartAngle = Actor.bIsEnabled ? Actor.StartAngle : Global.StartAngle;
+		Shot.EndAngle = Actor.bIsEnabled ? Actor.EndAngle : Global.EndAngle;
+		Shot.bFixPivot = Global.bFixPivot || Actor.bFixPivot;
+		Shot.bCenterPivot = Global.bCenterPivot || Actor.bCenterPivot;
+		return Shot;
+	}
+
+	friend uint32 GetTypeHash(const FCustomRenderShotSettings& Shot)
+	{
+		uint32 Hash = GetTypeHash(Shot.CameraHeight);
+		Hash = HashCombine(Hash, GetTypeHash(Shot.RadiusMultiplier));
+		Hash = HashCombine(Hash, GetTypeHash(Shot.LookatHeightAdjust));
+		Hash = HashCombine(Hash, GetTypeHash(Shot.StartAngle));
+		Hash = HashCombine(Hash, GetTypeHash(Shot.EndAngle));
+		Hash = HashCombine(Hash, uint32(Shot.bFixPivot) | (uint32(Shot.bCenterPivot) << 1));
+		return Hash;
+	}
+};
+
+/**
+ * Settings of one generation run: the global values plus one entry per target.
+ * Per object entries are addressed by their index in Actors, never by actor label.
+ */
+struct FCustomRenderSettings
+{
+	FCustomRenderGlobalSettings Global;
+	TArray<FCustomRenderActorSettings> Actors;
+
+	/** Start over with default per object settings for the given targets. */
+	void Reset(const TArray<FCustomRenderTarget>& InTargets)
+	{
+		Actors.Reset(InTargets.Num());
+		for (const FCustomRenderTarget& Target : InTargets)
+		{
+			FCustomRenderActorSettings ActorSettings;
+			ActorSettings.Target = Target;
+			Actors.Add(ActorSettings);
+		}
+	}
+
+	/** Start over with default per object settings for the given actors, one target each. */
+	void Reset(const TArray<AActor*>& InActors)
+	{
+		Reset(TArray<FCustomRenderTarget>(InActors));
+	}
+
+	/** Key of a per object field for SetValue, the actor index is stored in the FName number. */
+	static FName MakeActorKey(const TCHAR* Field, int32 ActorIndex)
+	{
+		return FName(Field, ActorIndex + 1);
+	}
+
+	/** Assign a value by name, the name of a global setting or a per object key made by MakeActorKey. */
+	void SetValue(FName Tag, float Value)
+	{
+		const bool bValue = Value != 0.0f;
+
+		if (Tag.GetNumber() > 0)
+		{
+			const int32 Index = Tag.GetNumber() - 1;
+			if (!Actors.IsValidIndex(Index)) return;
+
+			FCustomRenderActorSettings& A = Actors[Index];
+			const FName Field(Tag, 0);
+			if (Field == TEXT("isEnabled")) A.bIsEnabled = bValue;
+			else if (Field == TEXT("CH")) A.CameraHeight = Value;
+			else if (Field == TEXT("R")) A.Radius = Value;
+			else if (Field == TEXT("LH")) A.LookatHeightAdjust = Value;
+			else if (Field == TEXT("SA")) A.StartAngle = Value;
+			else if (Field == TEXT("EA")) A.EndAngle = Value;
+			else if (Field == TEXT("FP")) A.bFixPivot = bValue;
+			else if (Field == TEXT("CP")) A.bCenterPivot = bValue;
+			return;
+		}
+
+		FCustomRenderGlobalSettings& G = Global;
+		if (Tag == TEXT("Aperture")) G.Aperture = Value;
+		else if (Tag == TEXT("FocalLength")) G.FocalLength = Value;
+		else if (Tag == TEXT("CameraHeight")) G.CameraHeight = Value;
+		else if (Tag == TEXT("RadiusMultiplier")) G.RadiusMultiplier = Value;
+		else if (Tag == TEXT("StartAngle")) G.StartAngle = Value;
+		else if (Tag == TEXT("EndAngle")) G.EndAngle = Value;
+		else if (Tag == TEXT("LookatHeightAdjust")) G.LookatHeightAdjust = Value;
+		else if (Tag == TEXT("FPS")) G.FPS = Value;
+		else if (Tag == TEXT("FixPivot")) G.bFixPivot = bValue;
+		else if (Tag == TEXT("CenterPivot")) G.bCenterPivot = bValue;
+		else if (Tag == TEXT("Incremental")) G.bIncremental = bValue;
+		else if (Tag == TEXT("MinimalKeys")) G.bMinimalKeys = bValue;
+		else if (Tag == TEXT("MaxKeyError")) G.MaxKeyError = Value;
+		else if (Tag == TEXT("MaxAngleError")) G.MaxAngleError = Value;
+		else if (Tag == TEXT("BakeLookAt")) G.bBakeLookAt = bValue;
+		else if (Tag == TEXT("WriteManifest")) G.bWriteManifest = bValue;
+		else if (Tag == TEXT("WriteManifestCsv")) G.bWriteManifestCsv = bValue;
+		else if (Tag == TEXT("CoveragePlanner")) G.bCoveragePlanner = bValue;
+		else if (Tag == TEXT("CoverageViewAngle")) G.CoverageViewAngle = Value;
+		else if (Tag == TEXT("TargetCoverage")) G.TargetCoverage = Value;
+		else if (Tag == TEXT("MinElevation")) G.MinElevation = Value;
+		else if (Tag == TEXT("MaxElevation")) G.MaxElevation = Value;
+		else if (Tag == TEXT("AdaptiveDuration")) G.bAdaptiveDuration = bValue;
+		else if (Tag == TEXT("CameraSpeed")) G.CameraSpeed = Value;
+		else if (Tag == TEXT("AngularSpeed")) G.AngularSpeed = Value;
+		else if (Tag == TEXT("MinShotSeconds")) G.MinShotSeconds = Value;
+		else if (Tag == TEXT("MaxShotSeconds")) G.MaxShotSeconds = Value;
+		else if (Tag == TEXT("ClusterTargets")) G.bClusterTargets = bValue;
+		else if (Tag == TEXT("ClusterGap")) G.ClusterGap = Value;
+		else if (Tag == TEXT("MaxClusterSize")) G.MaxClusterSize = Value;
+		else if (Tag == TEXT("ShardSize")) G.ShardSize = FMath::Max(0, FMath::RoundToInt(Value));
+		else if (Tag == TEXT("RebuildShard")) G.RebuildShard = FMath::Max(int32(INDEX_NONE), FMath::RoundToInt(Value));
+		else if (Tag == TEXT("CheckVisibility")) G.bCheckVisibility = bValue;
+		else if (Tag == TEXT("AdjustOccluded")) G.bAdjustOccluded = bValue;
+		else if (Tag == TEXT("VisibilitySamples")) G.VisibilitySamples = FMath::Max(2, FMath::RoundToInt(Value));
+		else if (Tag == TEXT("MinVisibility")) G.MinVisibility = Value;
+	}
+};
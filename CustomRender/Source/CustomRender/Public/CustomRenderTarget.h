@@ -0,0 +1,59 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AActor;
+class UInstancedStaticMeshComponent;
+
+/**
+ * What one shot is generated for: a whole actor, or a single instance of an instanced static mesh
+ * component. Instances are addressed by index, so they never need an actor of their own.
+ */
+struct FCustomRenderTarget
+{
+	/** The target actor, or the owner of Component for an instance */
+	TWeakObjectPtr<AActor> Actor;
+
+	TWeakObjectPtr<UInstancedStaticMeshComponent> Component;
+	int32 Instance = INDEX_NONE;
+
+	FCustomRenderTarget() {}
+
+	FCustomRenderTarget(AActor* InActor)
+		: Actor(InActor)
+	{}
+
+	FCustomRenderTarget(UInstancedStaticMeshComponent* InComponent, int32 InInstance);
+
+	bool IsInstance() const { return Instance != INDEX_NONE; }
+
+	/** @return false once the actor is gone, or the instance was removed from its component */
+	bool IsValid() const;
+
+	AActor* GetActor() const { return Actor.Get(); }
+
+	/** Actor label, followed by the component name and instance index for an instance */
+	FString GetLabel() const;
+
+	/** World transform of the actor or of the instance */
+	FTransform GetTransform() const;
+
+	/**
+	 * The targets for a selection. Actors whose only primitives are instanced static meshes, like foliage,
+	 * are replaced with one target per instance. Every other actor is a target of its own.
+	 */
+	static void Expand(const TArray<AActor*>& Actors, TArray<FCustomRenderTarget>& OutTargets);
+
+	bool operator==(const FCustomRenderTarget& Other) const
+	{
+		return Actor == Other.Actor && Component == Other.Component && Instance == Other.Instance;
+	}
+
+	friend uint32 GetTypeHash(const FCustomRenderTarget& Target)
+	{
+		return HashCombine(GetTypeHash(Target.Actor), HashCombine(GetTypeHash(Target.Component), GetTypeHash(Target.Instance)));
+	}
+};
@@ -0,0 +1,168 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "OrbitBatch.h"
+#include "OrbitCoreTestUtils.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+
+using namespace OrbitCore;
+
+namespace
+{
+	// Largest error of the sin/cos polynomial against the double precision functions of the same float input
+	constexpr double SinCosBound = 2e-7;
+
+	/** Exact position in double precision, Theta computed from the float batch parameters */
+	Vec3 ExactPosition(const OrbitBatch & Batch, size_t Camera, int Key, int NumKeys)
+	{
+		const double Step = NumKeys > 1 ? double(Batch.RangeAngle[Camera]) / double(NumKeys - 1) : 0.0;
+		const double Theta = double(Batch.StartAngle[Camera]) + Key * Step;
+		return Vec3{ Batch.OriginX[Camera] + Batch.Radius[Camera] * std::cos(Theta), Batch.OriginY[Camera] + Batch.Radius[Camera] * std::sin(Theta), Batch.Height[Camera] };
+	}
+
+	/** Error bound of one evaluated position: the polynomial, the float angle and the float sum */
+	double PositionBound(const OrbitBatch & Batch, size_t Camera)
+	{
+		const double MaxTheta = std::fabs(Batch.StartAngle[Camera]) + std::fabs(Batch.RangeAngle[Camera]);
+		const double Magnitude = std::max(std::fabs(Batch.OriginX[Camera]), std::fabs(Batch.OriginY[Camera])) + Batch.Radius[Camera];
+		const double Epsilon = std::numeric_limits<float>::epsilon();
+		return Batch.Radius[Camera] * (SinCosBound + 2.0 * Epsilon * (1.0 + MaxTheta)) + 2.0 * Epsilon * Magnitude;
+	}
+}
+
+TEST(Batch, SinCosStaysWithinBound)
+{
+	double MaxError = 0.0;
+	for (double X = -64.0; X <= 64.0; X += 1.0 / 1024.0)
+	{
+		const float F = float(X);
+		float S, C;
+		Detail::SinCos(F, S, C);
+		MaxError = std::max(MaxError, std::fabs(S - std::sin(double(F))));
+		MaxError = std::max(MaxError, std::fabs(C - std::cos(double(F))));
+	}
+	EXPECT_LT(MaxError, SinCosBound);
+}
+
+TEST(Batch, VectorKernelsMatchScalarKernel)
+{
+#if ORBITCORE_SSE2 || ORBITCORE_AVX2
+	for (double X = -64.0; X <= 64.0; X += 1.0 / 64.0)
+	{
+		float Lanes[8];
+		for (int l = 0; l < 8; l++) Lanes[l] = float(X + l * 0.37);
+
+		float ScalarSin[8], ScalarCos[8];
+		for (int l = 0; l < 8; l++) Detail::SinCos(Lanes[l], ScalarSin[l], ScalarCos[l]);
+
+#if ORBITCORE_SSE2
+		{
+			__m128 S, C;
+			Detail::SinCos4(_mm_loadu_ps(Lanes), S, C);
+			float OutSin[4], OutCos[4];
+			_mm_storeu_ps(OutSin, S);
+			_mm_storeu_ps(OutCos, C);
+			for (int l = 0; l < 4; l++)
+			{
+				EXPECT_NEAR(OutSin[l], ScalarSin[l], 1e-7) << Lanes[l];
+				EXPECT_NEAR(OutCos[l], ScalarCos[l], 1e-7) << Lanes[l];
+			}
+		}
+#endif
+#if ORBITCORE_AVX2
+		{
+			__m256 S, C;
+			Detail::SinCos8(_mm256_loadu_ps(Lanes), S, C);
+			float OutSin[8], OutCos[8];
+			_mm256_storeu_ps(OutSin, S);
+			_mm256_storeu_ps(OutCos, C);
+			for (int l = 0; l < 8; l++)
+			{
+				EXPECT_NEAR(OutSin[l], ScalarSin[l], 1e-7) << Lanes[l];
+				EXPECT_NEAR(OutCos[l], ScalarCos[l], 1e-7) << Lanes[l];
+			}
+		}
+#endif
+	}
+#else
+	GTEST_SKIP() << "Built without SIMD kernels";
+#endif
+}
+
+TEST(Batch, PositionsStayWithinErrorBound)
+{
+	OrbitBatch Batch;
+	for (const OrbitParams & P : OrbitCoreTest::TestOrbits()) Batch.Add(P);
+
+	// Every key count from 1 to 40 covers the AVX2, SSE2 and scalar tails in all combinations
+	for (int NumKeys = 1; NumKeys <= 40; NumKeys++)
+	{
+		OrbitBatchPositions Positions;
+		Positions.Resize(Batch.Num(), NumKeys);
+		EvaluateBatch(Batch, 0, Batch.Num(), Positions);
+
+		for (size_t c = 0; c < Batch.Num(); c++)
+		{
+			const double Bound = PositionBound(Batch, c);
+			for (int k = 0; k < NumKeys; k++)
+			{
+				const Vec3 Exact = ExactPosition(Batch, c, k, NumKeys);
+				const size_t Index = Positions.Offset(c) + k;
+				EXPECT_NEAR(Positions.X[Index], Exact.X, Bound) << NumKeys << " keys, camera " << c << " key " << k;
+				EXPECT_NEAR(Positions.Y[Index], Exact.Y, Bound) << NumKeys << " keys, camera " << c << " key " << k;
+				EXPECT_EQ(Positions.Z[Index], float(Exact.Z));
+			}
+		}
+	}
+}
+
+TEST(Batch, CamerasKeepTheirOwnKeyCounts)
+{
+	OrbitBatch Batch;
+	for (const OrbitParams & P : OrbitCoreTest::TestOrbits()) Batch.Add(P);
+
+	const std::vector<int> KeysPerCamera = { 30, 0, 9, 1, 17 };
+	OrbitBatchPositions Positions;
+	Positions.Resize(KeysPerCamera);
+	ASSERT_EQ(Positions.X.size(), 57u);
+	EvaluateBatch(Batch, 0, Batch.Num(), Positions);
+
+	size_t Offset = 0;
+	for (size_t c = 0; c < Batch.Num(); c++)
+	{
+		EXPECT_EQ(Positions.Offset(c), Offset);
+		EXPECT_EQ(Positions.NumKeysOf(c), KeysPerCamera[c]);
+		for (int k = 0; k < KeysPerCamera[c]; k++)
+		{
+			const Vec3 Exact = ExactPosition(Batch, c, k, KeysPerCamera[c]);
+			EXPECT_NEAR(Positions.X[Offset + k], Exact.X, PositionBound(Batch, c));
+			EXPECT_NEAR(Positions.Y[Offset + k], Exact.Y, PositionBound(Batch, c));
+		}
+		Offset += KeysPerCamera[c];
+	}
+}
+
+TEST(Batch, RangesOnlyWriteTheirCameras)
+{
+	OrbitBatch Batch;
+	for (const OrbitParams & P : OrbitCoreTest::TestOrbits()) Batch.Add(P);
+
+	OrbitBatchPositions Positions;
+	Positions.Resize(Batch.Num(), 12);
+	const float Untouched = -12345.0f;
+	std::fill(Positions.X.begin(), Positions.X.end(), Untouched);
+
+	// The way the editor splits a batch over worker threads
+	EvaluateBatch(Batch, 1, 3, Positions);
+
+	for (size_t c = 0; c < Batch.Num(); c++)
+	{
+		const bool bInRange = c >= 1 && c < 3;
+		for (int k = 0; k < 12; k++)
+		{
+			EXPECT_EQ(Positions.X[Positions.Offset(c) + k] == Untouched, !bInRange) << "camera " << c;
+		}
+	}
+}
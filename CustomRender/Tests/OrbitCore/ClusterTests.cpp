@@ -0,0 +1,161 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "OrbitCluster.h"
+
+#include <gtest/gtest.h>
+
+using namespace OrbitCore;
+
+namespace
+{
+	ClusterBounds Box(double X, double Y, double Z, double HalfSize)
+	{
+		return ClusterBounds{ Vec3{ X, Y, Z }, Vec3{ HalfSize, HalfSize, HalfSize } };
+	}
+
+	/** Every object exactly once, members ascending, clusters ordered by their first member */
+	void ExpectPartition(const std::vector<std::vector<int>> & Clusters, size_t NumObjects)
+	{
+		std::vector<int> Seen(NumObjects, 0);
+		int PreviousFirst = -1;
+		for (const auto & Cluster : Clusters)
+		{
+			ASSERT_FALSE(Cluster.empty());
+			EXPECT_GT(Cluster[0], PreviousFirst);
+			PreviousFirst = Cluster[0];
+			for (size_t m = 0; m < Cluster.size(); m++)
+			{
+				if (m > 0) { EXPECT_LT(Cluster[m - 1], Cluster[m]); }
+				ASSERT_LT(size_t(Cluster[m]), NumObjects);
+				Seen[Cluster[m]]++;
+			}
+		}
+		for (size_t i = 0; i < NumObjects; i++) EXPECT_EQ(Seen[i], 1) << "object " << i;
+	}
+
+	double ClusterSize(const std::vector<ClusterBounds> & Objects, const std::vector<int> & Cluster)
+	{
+		ClusterBounds Bounds = Objects[Cluster[0]];
+		for (int i : Cluster) Bounds = UnionBounds(Bounds, Objects[i]);
+		return 2.0 * std::max(Bounds.Extent.X, std::max(Bounds.Extent.Y, Bounds.Extent.Z));
+	}
+}
+
+TEST(Cluster, BoundsHelpers)
+{
+	const ClusterBounds A = Box(0, 0, 0, 10), B = Box(50, 0, 0, 10);
+	EXPECT_DOUBLE_EQ(BoundsGap(A, B), 30.0);
+	EXPECT_DOUBLE_EQ(BoundsGap(A, Box(5, 5, 5, 10)), 0.0);
+	EXPECT_DOUBLE_EQ(BoundsGap(A, Box(40, 40, 0, 10)), std::sqrt(2.0 * 20 * 20));
+
+	const ClusterBounds U = UnionBounds(A, B);
+	EXPECT_DOUBLE_EQ(U.Center.X, 25.0);
+	EXPECT_DOUBLE_EQ(U.Extent.X, 35.0);
+	EXPECT_DOUBLE_EQ(U.Extent.Y, 10.0);
+}
+
+TEST(Cluster, LinksObjectsWithinTheGap)
+{
+	// Two groups 30 apart inside, 200 apart between them
+	const std::vector<ClusterBounds> Objects = { Box(0, 0, 0, 10), Box(500, 0, 0, 10), Box(50, 0, 0, 10), Box(550, 0, 0, 10), Box(100, 0, 0, 10) };
+	ClusterParams P;
+	P.MaxGap = 35.0;
+	P.MaxSize = 1000.0;
+
+	const auto Clusters = ClusterObjects(Objects, P);
+	ExpectPartition(Clusters, Objects.size());
+	ASSERT_EQ(Clusters.size(), 2u);
+	EXPECT_EQ(Clusters[0], (std::vector<int>{ 0, 2, 4 }));
+	EXPECT_EQ(Clusters[1], (std::vector<int>{ 1, 3 }));
+
+	// Just below the gap nothing links
+	P.MaxGap = 29.0;
+	EXPECT_EQ(ClusterObjects(Objects, P).size(), Objects.size());
+}
+
+TEST(Cluster, ClustersStayWithinTheSizeLimit)
+{
+	// A row of touching boxes, linked end to end until the size limit stops each cluster
+	std::vector<ClusterBounds> Objects;
+	for (int i = 0; i < 40; i++) Objects.push_back(Box(i * 25.0, (i % 3) * 5.0, 0, 10));
+
+	ClusterParams P;
+	P.MaxGap = 10.0;
+	P.MaxSize = 120.0;
+
+	const auto Clusters = ClusterObjects(Objects, P);
+	ExpectPartition(Clusters, Objects.size());
+	EXPECT_LT(Clusters.size(), Objects.size());
+	for (const auto & Cluster : Clusters)
+	{
+		EXPECT_LE(ClusterSize(Objects, Cluster), P.MaxSize + 1e-9);
+	}
+}
+
+TEST(Cluster, LargeObjectsStayAlone)
+{
+	// The wall is bigger than a cluster may be, the small boxes next to it cluster without it
+	const std::vector<ClusterBounds> Objects = { Box(0, 0, 0, 10), Box(30, 0, 0, 400), Box(-30, 0, 0, 10) };
+	ClusterParams P;
+	P.MaxGap = 50.0;
+	P.MaxSize = 300.0;
+
+	const auto Clusters = ClusterObjects(Objects, P);
+	ExpectPartition(Clusters, Objects.size());
+	ASSERT_EQ(Clusters.size(), 2u);
+	EXPECT_EQ(Clusters[0], (std::vector<int>{ 0, 2 }));
+	EXPECT_EQ(Clusters[1], (std::vector<int>{ 1 }));
+}
+
+TEST(Cluster, ClosestPairsMergeFirst)
+{
+	// 0 and 1 are closer than 1 and 2, and all three don't fit together
+	const std::vector<ClusterBounds> Objects = { Box(0, 0, 0, 20), Box(45, 0, 0, 20), Box(100, 0, 0, 20) };
+	ClusterParams P;
+	P.MaxGap = 20.0;
+	P.MaxSize = 100.0;
+
+	const auto Clusters = ClusterObjects(Objects, P);
+	ExpectPartition(Clusters, Objects.size());
+	ASSERT_EQ(Clusters.size(), 2u);
+	EXPECT_EQ(Clusters[0], (std::vector<int>{ 0, 1 }));
+	EXPECT_EQ(Clusters[1], (std::vector<int>{ 2 }));
+}
+
+TEST(Cluster, MatchesBruteForceOnAScatter)
+{
+	// Neighbouring grid cells must find every link a comparison of all pairs finds
+	std::vector<ClusterBounds> Objects;
+	uint32_t Seed = 12345;
+	auto Random = [&]() { Seed = Seed * 1664525u + 1013904223u; return double(Seed >> 8) / double(1 << 24); };
+	for (int i = 0; i < 300; i++) Objects.push_back(Box(Random() * 3000.0 - 1500.0, Random() * 3000.0 - 1500.0, Random() * 200.0, 5.0 + Random() * 40.0));
+
+	ClusterParams P;
+	const auto Clusters = ClusterObjects(Objects, P);
+	ExpectPartition(Clusters, Objects.size());
+
+	std::vector<int> ClusterOf(Objects.size());
+	for (size_t c = 0; c < Clusters.size(); c++)
+	{
+		EXPECT_LE(ClusterSize(Objects, Clusters[c]), P.MaxSize + 1e-9);
+		for (int i : Clusters[c]) ClusterOf[i] = int(c);
+	}
+
+	// Two linkable objects in different clusters are only allowed when joining the clusters would be too big
+	for (size_t i = 0; i < Objects.size(); i++)
+	{
+		for (size_t j = i + 1; j < Objects.size(); j++)
+		{
+			if (ClusterOf[i] == ClusterOf[j] || BoundsGap(Objects[i], Objects[j]) > P.MaxGap) continue;
+
+			std::vector<int> Joined = Clusters[ClusterOf[i]];
+			Joined.insert(Joined.end(), Clusters[ClusterOf[j]].begin(), Clusters[ClusterOf[j]].end());
+			EXPECT_GT(ClusterSize(Objects, Joined), P.MaxSize) << i << " and " << j;
+		}
+	}
+}
+
+TEST(Cluster, EmptyInput)
+{
+	EXPECT_TRUE(ClusterObjects({}, ClusterParams()).empty());
+}
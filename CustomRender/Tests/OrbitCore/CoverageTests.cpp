@@ -0,0 +1,166 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "OrbitCoverage.h"
+
+#include <gtest/gtest.h>
+
+using namespace OrbitCore;
+
+namespace
+{
+	double PathLength(const std::vector<Vec3> & Views)
+	{
+		double Length = 0.0;
+		for (size_t i = 0; i + 1 < Views.size(); i++)
+		{
+			const double DX = Views[i + 1].X - Views[i].X, DY = Views[i + 1].Y - Views[i].Y, DZ = Views[i + 1].Z - Views[i].Z;
+			Length += std::sqrt(DX * DX + DY * DY + DZ * DZ);
+		}
+		return Length;
+	}
+
+	bool SameDirection(const Vec3 & A, const Vec3 & B)
+	{
+		return std::fabs(A.X - B.X) < 1e-12 && std::fabs(A.Y - B.Y) < 1e-12 && std::fabs(A.Z - B.Z) < 1e-12;
+	}
+}
+
+TEST(Coverage, FibonacciDirectionsStayInTheBand)
+{
+	for (const auto & Band : { std::make_pair(0.0, 60.0), std::make_pair(-30.0, 30.0), std::make_pair(45.0, 10.0) })
+	{
+		const std::vector<Vec3> Directions = FibonacciDirections(500, Band.first, Band.second);
+		ASSERT_EQ(Directions.size(), 500u);
+
+		const double ZMin = std::sin(DegreesToRadians(std::min(Band.first, Band.second)));
+		const double ZMax = std::sin(DegreesToRadians(std::max(Band.first, Band.second)));
+		for (const Vec3 & D : Directions)
+		{
+			EXPECT_NEAR(std::sqrt(Dot(D, D)), 1.0, 1e-12);
+			EXPECT_GE(D.Z, ZMin - 1e-12);
+			EXPECT_LE(D.Z, ZMax + 1e-12);
+		}
+	}
+
+	EXPECT_TRUE(FibonacciDirections(0, 0.0, 60.0).empty());
+}
+
+TEST(Coverage, MeasureCoverageCountsSamplesWithinTheViewAngle)
+{
+	const std::vector<Vec3> Samples = FibonacciDirections(400, 0.0, 60.0);
+	EXPECT_DOUBLE_EQ(MeasureCoverage({}, Samples, 25.0), 0.0);
+	EXPECT_DOUBLE_EQ(MeasureCoverage(Samples, Samples, 1.0), 1.0);
+	EXPECT_DOUBLE_EQ(MeasureCoverage({ Vec3{ 1, 0, 0 } }, {}, 25.0), 1.0);
+
+	// One view sees exactly the samples within the angle
+	const Vec3 View = { 1, 0, 0 };
+	size_t Within = 0;
+	for (const Vec3 & S : Samples) Within += Dot(S, View) >= std::cos(DegreesToRadians(25.0)) ? 1 : 0;
+	EXPECT_DOUBLE_EQ(MeasureCoverage({ View }, Samples, 25.0), double(Within) / Samples.size());
+}
+
+TEST(Coverage, PlanReachesTheTargetCoverage)
+{
+	for (double ViewAngle : { 15.0, 25.0, 40.0 })
+	{
+		for (double TargetCoverage : { 0.5, 0.9, 0.99 })
+		{
+			CoverageParams P;
+			P.ViewAngle = ViewAngle;
+			P.TargetCoverage = TargetCoverage;
+
+			const std::vector<Vec3> Views = PlanCoverage(P);
+			const std::vector<Vec3> Samples = FibonacciDirections(P.NumSamples, P.MinElevation, P.MaxElevation);
+			EXPECT_GE(MeasureCoverage(Views, Samples, P.ViewAngle), TargetCoverage) << ViewAngle << " degrees, " << TargetCoverage;
+			EXPECT_LT(Views.size(), size_t(P.NumCandidates));
+
+			// Every view is one of the candidates
+			const std::vector<Vec3> Candidates = FibonacciDirections(P.NumCandidates, P.MinElevation, P.MaxElevation);
+			for (const Vec3 & V : Views)
+			{
+				EXPECT_TRUE(std::any_of(Candidates.begin(), Candidates.end(), [&](const Vec3 & C) { return SameDirection(C, V); }));
+			}
+		}
+	}
+}
+
+TEST(Coverage, WiderViewsNeedFewerViews)
+{
+	size_t Previous = size_t(-1);
+	for (double ViewAngle : { 10.0, 20.0, 30.0, 45.0 })
+	{
+		CoverageParams P;
+		P.ViewAngle = ViewAngle;
+		const size_t NumViews = PlanCoverage(P).size();
+		EXPECT_LE(NumViews, Previous) << ViewAngle << " degrees";
+		Previous = NumViews;
+	}
+}
+
+TEST(Coverage, UnreachableTargetStopsWhenNothingIsLeftToGain)
+{
+	// Candidates much sparser than the samples with a tiny view angle leave samples nobody sees
+	CoverageParams P;
+	P.ViewAngle = 0.5;
+	P.TargetCoverage = 1.0;
+	P.NumCandidates = 16;
+
+	const std::vector<Vec3> Views = PlanCoverage(P);
+	const std::vector<Vec3> Samples = FibonacciDirections(P.NumSamples, P.MinElevation, P.MaxElevation);
+	EXPECT_LE(Views.size(), size_t(P.NumCandidates));
+	EXPECT_LT(MeasureCoverage(Views, Samples, P.ViewAngle), 1.0);
+
+	P.TargetCoverage = 0.0;
+	EXPECT_TRUE(PlanCoverage(P).empty());
+}
+
+TEST(Coverage, OrderViewPathIsShortAndStartsLowInFront)
+{
+	CoverageParams P;
+	P.ViewAngle = 20.0;
+	std::vector<Vec3> Views = PlanCoverage(P);
+	ASSERT_GE(Views.size(), 4u);
+
+	// The same views shuffled come back in an order no longer than the shuffled one
+	std::vector<Vec3> Shuffled = Views;
+	std::reverse(Shuffled.begin() + 1, Shuffled.end());
+	std::swap(Shuffled[1], Shuffled[Shuffled.size() / 2]);
+	const double ShuffledLength = PathLength(Shuffled);
+
+	OrderViewPath(Shuffled);
+	ASSERT_EQ(Shuffled.size(), Views.size());
+	for (const Vec3 & V : Views)
+	{
+		EXPECT_TRUE(std::any_of(Shuffled.begin(), Shuffled.end(), [&](const Vec3 & S) { return SameDirection(S, V); }));
+	}
+	EXPECT_LE(PathLength(Shuffled), ShuffledLength);
+
+	// The path starts at the lowest view, slightly favouring +X
+	for (const Vec3 & V : Shuffled)
+	{
+		EXPECT_LE(Shuffled[0].Z - 0.1 * Shuffled[0].X, V.Z - 0.1 * V.X + 1e-12);
+	}
+
+	// No 2-opt move is left that shortens the path
+	const double Length = PathLength(Shuffled);
+	for (size_t i = 0; i + 2 < Shuffled.size(); i++)
+	{
+		for (size_t j = i + 2; j < Shuffled.size(); j++)
+		{
+			std::vector<Vec3> Moved = Shuffled;
+			std::reverse(Moved.begin() + i + 1, Moved.begin() + j + 1);
+			EXPECT_GE(PathLength(Moved) + 1e-9, Length);
+		}
+	}
+}
+
+TEST(Coverage, PlannedViewsSitAtTheOrbitRadius)
+{
+	const OrbitParams P = { { 100, -200, 30 }, { 40, 60, 20 }, 2.5, 150.0, 0.0, 180.0 };
+	for (const Vec3 & D : FibonacciDirections(64, -20.0, 70.0))
+	{
+		const Vec3 Position = PlannedViewPosition(P, D);
+		const double DX = Position.X - P.Origin.X, DY = Position.Y - P.Origin.Y, DZ = Position.Z - P.Origin.Z;
+		EXPECT_NEAR(std::sqrt(DX * DX + DY * DY + DZ * DZ), OrbitRadius(P), 1e-9);
+	}
+}
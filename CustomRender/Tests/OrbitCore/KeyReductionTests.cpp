@@ -0,0 +1,143 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "OrbitKeyReduction.h"
+#include "OrbitCoreTestUtils.h"
+
+#include <gtest/gtest.h>
+
+using namespace OrbitCore;
+
+namespace
+{
+	/** Largest position error of the keys, sampled much denser than FitOrbitKeys checks it */
+	double DenseKeyError(const OrbitParams & P, const std::vector<TangentKey> & Keys)
+	{
+		return MaxKeyError(P, Keys, 256);
+	}
+
+	/** Look at point of each test orbit, above its origin like the editor's LookatHeightAdjust */
+	Vec3 TestLookAt(const OrbitParams & P)
+	{
+		return Vec3{ P.Origin.X, P.Origin.Y, P.Origin.Z + P.Extent.Z * 0.5 };
+	}
+}
+
+TEST(KeyReduction, TangentMatchesFiniteDifference)
+{
+	for (const OrbitParams & P : OrbitCoreTest::TestOrbits())
+	{
+		const double H = 1e-6;
+		for (double T = 0.05; T < 1.0; T += 0.1)
+		{
+			const Vec3 A = EvaluatePosition(P, T - H), B = EvaluatePosition(P, T + H);
+			const Vec3 Tangent = EvaluateTangent(P, T);
+			const double Tolerance = 1e-6 * (1.0 + OrbitRadius(P) * std::fabs(P.EndAngle - P.StartAngle));
+			EXPECT_NEAR(Tangent.X, (B.X - A.X) / (2 * H), Tolerance);
+			EXPECT_NEAR(Tangent.Y, (B.Y - A.Y) / (2 * H), Tolerance);
+			EXPECT_NEAR(Tangent.Z, 0.0, Tolerance);
+		}
+	}
+}
+
+TEST(KeyReduction, PositionStaysWithinTolerance)
+{
+	for (const OrbitParams & P : OrbitCoreTest::TestOrbits())
+	{
+		for (double MaxError : { 0.01, 0.1, 1.0 })
+		{
+			std::vector<TangentKey> Keys;
+			FitOrbitKeys(P, MaxError, Keys);
+			ASSERT_GE(Keys.size(), 2u);
+			EXPECT_DOUBLE_EQ(Keys.front().T, 0.0);
+			EXPECT_DOUBLE_EQ(Keys.back().T, 1.0);
+
+			// The dense check may find a slightly larger peak than the 16 samples of the fit
+			EXPECT_LE(DenseKeyError(P, Keys), MaxError * 1.01) << "radius " << OrbitRadius(P) << " tolerance " << MaxError;
+		}
+	}
+}
+
+TEST(KeyReduction, FewestKeysForTolerance)
+{
+	const OrbitParams P = { { 0, 0, 0 }, { 50, 50, 50 }, 3.0, 150.0, 0.0, 180.0 };
+
+	std::vector<TangentKey> Keys;
+	FitOrbitKeys(P, 0.1, Keys);
+	EXPECT_LE(Keys.size(), 9u);
+
+	// One segment less breaks the tolerance
+	const int Segments = int(Keys.size()) - 1;
+	std::vector<TangentKey> Fewer;
+	for (int k = 0; k < Segments; k++)
+	{
+		const double T = double(k) / double(Segments - 1);
+		Fewer.push_back(TangentKey{ T, EvaluatePosition(P, T), EvaluateTangent(P, T) });
+	}
+	EXPECT_GT(MaxKeyError(P, Fewer), 0.1);
+}
+
+TEST(KeyReduction, LookAtTangentsMatchFiniteDifference)
+{
+	for (const OrbitParams & P : OrbitCoreTest::TestOrbits())
+	{
+		const Vec3 LookAt = TestLookAt(P);
+		const double H = 1e-6;
+		for (double T = 0.05; T < 1.0; T += 0.1)
+		{
+			const RotationKey Key = EvaluateLookAt(P, LookAt, T);
+			const RotationKey A = EvaluateLookAt(P, LookAt, T - H), B = EvaluateLookAt(P, LookAt, T + H);
+			EXPECT_NEAR(Key.PitchTangent, (B.Pitch - A.Pitch) / (2 * H), 1e-3);
+			EXPECT_NEAR(Key.YawTangent, UnwindDegrees(B.Yaw - A.Yaw, 0.0) / (2 * H), 1e-3);
+		}
+	}
+}
+
+TEST(KeyReduction, UnwindStaysWithinHalfTurn)
+{
+	EXPECT_DOUBLE_EQ(UnwindDegrees(-170.0, 170.0), 190.0);
+	EXPECT_DOUBLE_EQ(UnwindDegrees(170.0, -170.0), -190.0);
+	EXPECT_DOUBLE_EQ(UnwindDegrees(10.0, 725.0), 730.0);
+	EXPECT_DOUBLE_EQ(UnwindDegrees(45.0, 45.0), 45.0);
+}
+
+TEST(KeyReduction, RotationStaysWithinTolerance)
+{
+	for (const OrbitParams & P : OrbitCoreTest::TestOrbits())
+	{
+		const Vec3 LookAt = TestLookAt(P);
+		for (double MaxAngleError : { 0.01, 0.05, 0.5 })
+		{
+			std::vector<TangentKey> Keys;
+			std::vector<RotationKey> Rotation;
+			FitOrbitKeys(P, 0.1, LookAt, MaxAngleError, Keys, Rotation);
+			ASSERT_EQ(Rotation.size(), Keys.size());
+
+			// Position keeps its own bound, rotation keys share the position key times
+			EXPECT_LE(DenseKeyError(P, Keys), 0.1 * 1.01);
+			for (size_t k = 0; k < Keys.size(); k++)
+			{
+				EXPECT_DOUBLE_EQ(Rotation[k].T, Keys[k].T);
+				if (k > 0) { EXPECT_LT(std::fabs(Rotation[k].Yaw - Rotation[k - 1].Yaw), 180.0); }
+			}
+			EXPECT_LE(MaxLookAtError(P, LookAt, Rotation, 256), MaxAngleError * 1.01) << "radius " << OrbitRadius(P) << " tolerance " << MaxAngleError;
+		}
+	}
+}
+
+TEST(KeyReduction, CloseLookAtNeedsMoreKeysThanPosition)
+{
+	// A small orbit keeps its position within a millimetre with a few keys, but a look at point off its
+	// center, close to where it starts, swings the camera round much faster there
+	const OrbitParams P = { { 0, 0, 0 }, { 1, 1, 1 }, 20.0, 0.0, 0.0, 180.0 };
+	const Vec3 LookAt = { 15, 0, 0 };
+
+	std::vector<TangentKey> PositionOnly;
+	FitOrbitKeys(P, 0.1, PositionOnly);
+
+	std::vector<TangentKey> Keys;
+	std::vector<RotationKey> Rotation;
+	FitOrbitKeys(P, 0.1, LookAt, 0.05, Keys, Rotation);
+
+	EXPECT_GT(Keys.size(), PositionOnly.size());
+	EXPECT_LE(MaxLookAtError(P, LookAt, Rotation, 256), 0.05 * 1.01);
+}
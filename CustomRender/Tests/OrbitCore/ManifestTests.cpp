@@ -0,0 +1,234 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "OrbitManifest.h"
+#include "OrbitManifestReader.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+using namespace OrbitCore;
+
+namespace
+{
+	ManifestCamera MakeCamera(uint32_t Target, int32_t FirstFrame, int NumFrames)
+	{
+		ManifestCamera C;
+		C.Target = Target;
+		C.FirstFrame = FirstFrame;
+		C.NumFrames = NumFrames;
+		C.Orbit = OrbitParams{ { 100.0 * Target, -50, 0 }, { 50, 50, 50 }, 3.0, 150.0, 0.0, 180.0 };
+		C.LookAt = Vec3{ 100.0 * Target, -50, 25 };
+		C.FocalLength = 35.0f;
+		C.Aperture = 2.8f;
+		C.SensorWidth = 4.69469f;
+		C.SensorHeight = 3.518753f;
+		return C;
+	}
+
+	/** Manifest file of the test, removed again when the test ends */
+	class ManifestFile
+	{
+	public:
+		explicit ManifestFile(const char * Name) : Path(testing::TempDir() + Name) {}
+		~ManifestFile() { std::remove(Path.c_str()); }
+
+		void Write(const std::vector<ManifestCamera> & Cameras, float FramesPerSecond, const std::vector<std::string> & Names = { "Chair", "Table", "Lamp", "Sofa" })
+		{
+			std::string Bytes;
+			WriteManifest(Cameras, Names, FramesPerSecond, [&](const void * Data, size_t Size) { Bytes.append(static_cast<const char *>(Data), Size); });
+			WriteBytes(Bytes);
+		}
+
+		/** Rewrite the file with its header changed by Edit, and truncated to Size bytes when given */
+		template<typename EditFunc>
+		void Corrupt(EditFunc && Edit, size_t Size = size_t(-1))
+		{
+			std::string Bytes = ReadBytes();
+			ManifestHeader Header;
+			std::memcpy(&Header, Bytes.data(), sizeof(Header));
+			Edit(Header);
+			std::memcpy(&Bytes[0], &Header, sizeof(Header));
+			WriteBytes(Bytes.substr(0, Size));
+		}
+
+		std::string ReadBytes() const
+		{
+			std::string Bytes;
+			if (FILE * File = std::fopen(Path.c_str(), "rb"))
+			{
+				char Buffer[4096];
+				for (size_t Read; (Read = std::fread(Buffer, 1, sizeof(Buffer), File)) > 0; ) Bytes.append(Buffer, Read);
+				std::fclose(File);
+			}
+			return Bytes;
+		}
+
+		void WriteBytes(const std::string & Bytes) const
+		{
+			FILE * File = std::fopen(Path.c_str(), "wb");
+			ASSERT_NE(File, nullptr);
+			std::fwrite(Bytes.data(), 1, Bytes.size(), File);
+			std::fclose(File);
+		}
+
+		const std::string Path;
+	};
+
+	void ExpectSameRecord(const ManifestRecord & A, const ManifestRecord & B)
+	{
+		EXPECT_EQ(A.Camera, B.Camera);
+		EXPECT_EQ(A.Target, B.Target);
+		EXPECT_EQ(A.Frame, B.Frame);
+		for (int i = 0; i < 3; i++)
+		{
+			EXPECT_FLOAT_EQ(A.Position[i], B.Position[i]);
+			EXPECT_FLOAT_EQ(A.Rotation[i], B.Rotation[i]);
+		}
+		EXPECT_FLOAT_EQ(A.FocalLength, B.FocalLength);
+		EXPECT_FLOAT_EQ(A.SensorHeight, B.SensorHeight);
+	}
+}
+
+TEST(Manifest, RoundTripWithEqualFrameCounts)
+{
+	const std::vector<ManifestCamera> Cameras = { MakeCamera(0, 0, 30), MakeCamera(2, 30, 30), MakeCamera(1, 60, 30) };
+	ManifestFile File("OrbitCoreManifestEqual.bin");
+	File.Write(Cameras, 30.0f);
+
+	ManifestReader Reader;
+	ASSERT_TRUE(Reader.Open(File.Path.c_str()));
+	EXPECT_EQ(Reader.Header().NumCameras, 3u);
+	EXPECT_EQ(Reader.Header().FramesPerCamera, 30u);
+	EXPECT_FLOAT_EQ(Reader.Header().FramesPerSecond, 30.0f);
+	ASSERT_EQ(Reader.Num(), 90u);
+
+	for (uint32_t c = 0; c < Cameras.size(); c++)
+	{
+		for (int f = 0; f < Cameras[c].NumFrames; f++)
+		{
+			const ManifestRecord * Record = Reader.At(c, uint32_t(f));
+			ASSERT_NE(Record, nullptr);
+			ExpectSameRecord(*Record, MakeManifestRecord(Cameras[c], c, f));
+		}
+	}
+
+	EXPECT_EQ(Reader.At(0, 30), nullptr);
+	EXPECT_EQ(Reader.At(3, 0), nullptr);
+
+	// Records name their target through the table of the same file
+	EXPECT_EQ(Reader.Header().NumTargets, 4u);
+	EXPECT_EQ(Reader.TargetName(Reader.At(1, 0)->Target), "Lamp");
+	EXPECT_EQ(Reader.TargetName(0), "Chair");
+	EXPECT_EQ(Reader.TargetName(3), "Sofa");
+	EXPECT_EQ(Reader.TargetName(4), "");
+}
+
+TEST(Manifest, TargetNamesMayBeEmptyOrMissing)
+{
+	const std::vector<ManifestCamera> Cameras = { MakeCamera(0, 0, 4), MakeCamera(2, 4, 4) };
+	ManifestFile File("OrbitCoreManifestNames.bin");
+	ManifestReader Reader;
+
+	File.Write(Cameras, 30.0f, { "", "Unused", "Chair \"B\"" });
+	ASSERT_TRUE(Reader.Open(File.Path.c_str()));
+	EXPECT_EQ(Reader.TargetName(0), "");
+	EXPECT_EQ(Reader.TargetName(2), "Chair \"B\"");
+	EXPECT_EQ(Reader.Num(), 8u);
+
+	File.Write(Cameras, 30.0f, {});
+	ASSERT_TRUE(Reader.Open(File.Path.c_str()));
+	EXPECT_EQ(Reader.Header().NumTargets, 0u);
+	EXPECT_EQ(Reader.TargetName(0), "");
+	ExpectSameRecord(*Reader.At(1, 3), MakeManifestRecord(Cameras[1], 1, 3));
+}
+
+TEST(Manifest, EmptyManifestOpens)
+{
+	// A run without shots still writes its manifest, readers see no records rather than a broken file
+	ManifestFile File("OrbitCoreManifestEmpty.bin");
+	File.Write({}, 30.0f, {});
+
+	ManifestReader Reader;
+	ASSERT_TRUE(Reader.Open(File.Path.c_str()));
+	EXPECT_EQ(Reader.Header().NumCameras, 0u);
+	EXPECT_EQ(Reader.Num(), 0u);
+	EXPECT_EQ(Reader.At(0, 0), nullptr);
+	EXPECT_EQ(Reader.TargetName(0), "");
+}
+
+TEST(Manifest, RoundTripWithVariableFrameCounts)
+{
+	const std::vector<ManifestCamera> Cameras = { MakeCamera(0, 0, 12), MakeCamera(1, 12, 0), MakeCamera(2, 12, 45), MakeCamera(3, 57, 1) };
+	ManifestFile File("OrbitCoreManifestVariable.bin");
+	File.Write(Cameras, 24.0f);
+
+	ManifestReader Reader;
+	ASSERT_TRUE(Reader.Open(File.Path.c_str()));
+	EXPECT_EQ(Reader.Header().FramesPerCamera, ManifestVariableFrames);
+	ASSERT_EQ(Reader.Num(), 58u);
+
+	for (uint32_t c = 0; c < Cameras.size(); c++)
+	{
+		for (int f = 0; f < Cameras[c].NumFrames; f++)
+		{
+			const ManifestRecord * Record = Reader.At(c, uint32_t(f));
+			ASSERT_NE(Record, nullptr) << "camera " << c << " frame " << f;
+			ExpectSameRecord(*Record, MakeManifestRecord(Cameras[c], c, f));
+		}
+		EXPECT_EQ(Reader.At(c, uint32_t(Cameras[c].NumFrames)), nullptr) << "camera " << c;
+	}
+}
+
+TEST(Manifest, CsvHasOneLinePerRecord)
+{
+	const std::vector<ManifestCamera> Cameras = { MakeCamera(1, 0, 5), MakeCamera(0, 5, 3) };
+	std::string Csv;
+	WriteManifestCsv(Cameras, { "Chair", "Table" }, [&](const void * Data, size_t Size) { Csv.append(static_cast<const char *>(Data), Size); });
+
+	EXPECT_EQ(std::count(Csv.begin(), Csv.end(), '\n'), 1 + 5 + 3);
+	EXPECT_EQ(Csv.find("Camera,Target,TargetName,Frame"), 0u);
+	EXPECT_NE(Csv.find("\n0,1,\"Table\",0,"), std::string::npos);
+	EXPECT_NE(Csv.find("\n1,0,\"Chair\",5,"), std::string::npos);
+}
+
+TEST(Manifest, RejectsCorruptedHeaders)
+{
+	const std::vector<ManifestCamera> Cameras = { MakeCamera(0, 0, 10), MakeCamera(1, 10, 10) };
+	ManifestFile File("OrbitCoreManifestCorrupt.bin");
+	ManifestReader Reader;
+
+	auto ExpectRejected = [&](const char * What, std::function<void(ManifestHeader &)> Edit, size_t Size = size_t(-1)) {
+		File.Write(Cameras, 30.0f);
+		File.Corrupt(Edit, Size);
+		EXPECT_FALSE(Reader.Open(File.Path.c_str())) << What;
+		EXPECT_FALSE(Reader.IsOpen()) << What;
+		EXPECT_EQ(Reader.Num(), 0u) << What;
+	};
+
+	ExpectRejected("truncated records", [](ManifestHeader &) {}, sizeof(ManifestHeader) + 19 * sizeof(ManifestRecord));
+	ExpectRejected("truncated header", [](ManifestHeader &) {}, sizeof(ManifestHeader) - 4);
+	ExpectRejected("magic", [](ManifestHeader & H) { H.Magic[0] = 'X'; });
+	ExpectRejected("version", [](ManifestHeader & H) { H.Version = 2; });
+	ExpectRejected("record count wrapping the size", [](ManifestHeader & H) { H.NumRecords = (uint64_t(1) << 63) + 20; H.RecordSize = 64; });
+	ExpectRejected("record count past the end", [](ManifestHeader & H) { H.NumRecords = 21; });
+	ExpectRejected("header past the end", [](ManifestHeader & H) { H.HeaderSize = 0xFFFFFFF0u; });
+	ExpectRejected("small record", [](ManifestHeader & H) { H.RecordSize = sizeof(ManifestRecord) - 4; });
+	ExpectRejected("misaligned record", [](ManifestHeader & H) { H.RecordSize = sizeof(ManifestRecord) + 1; });
+	ExpectRejected("records without cameras", [](ManifestHeader & H) { H.NumCameras = 0; });
+	ExpectRejected("no frames per camera", [](ManifestHeader & H) { H.FramesPerCamera = 0; });
+	ExpectRejected("frames per camera not matching the records", [](ManifestHeader & H) { H.FramesPerCamera = 11; });
+	ExpectRejected("target table past the end", [](ManifestHeader & H) { H.TargetTableOffset += 4; });
+	ExpectRejected("target table offset wrapping", [](ManifestHeader & H) { H.TargetTableOffset = ~uint64_t(0) - 2; });
+	ExpectRejected("more targets than the table holds", [](ManifestHeader & H) { H.NumTargets = H.TargetTableSize; });
+	ExpectRejected("truncated target names", [](ManifestHeader &) {}, sizeof(ManifestHeader) + 20 * sizeof(ManifestRecord) + 4 * sizeof(uint32_t) + 3);
+	ExpectRejected("names past the text", [](ManifestHeader & H) { H.NumTargets = 8; });
+
+	// The untouched file still opens with the same reader
+	File.Write(Cameras, 30.0f);
+	EXPECT_TRUE(Reader.Open(File.Path.c_str()));
+	EXPECT_EQ(Reader.Num(), 20u);
+}
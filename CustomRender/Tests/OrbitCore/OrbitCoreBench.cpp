@@ -0,0 +1,256 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+// Microbenchmark of the orbit math, single threaded:
+//
+//   OrbitCoreBench [--cameras 10000] [--keys 30] [--repeat 5]
+//
+// Times the double precision reference (GenerateKeys, one orbit after the other) and the batched
+// SIMD evaluation (EvaluateBatch) on the same orbits, and reports the best of the repeats.
+//
+//   OrbitCoreBench --sweep [--sizes 10,100,1000,10000,100000] [--fps 30,60] [--max-error 0.1]
+//                  [--repeat 5] [--baseline BenchmarkBaseline.csv] [--tolerance 0.25] [--out Benchmark.csv]
+//
+// The -MathOnly mode of the CustomRenderBenchmark commandlet without Unreal: RunBenchmark for every
+// size and FPS, written as the same Math rows of its Benchmark.csv. With --baseline each total is
+// compared with the row of the same size and FPS, and the exit code is 1 when one is slower than the
+// baseline by more than the tolerance or missing from it. BenchmarkBaseline.csv next to this file is
+// the reference, the commandlet's -UpdateBaseline adds its Generate rows to the same file.
+
+#include "OrbitTrajectory.h"
+#include "OrbitBatch.h"
+#include "OrbitBenchmark.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+
+using namespace OrbitCore;
+
+namespace
+{
+	struct Options
+	{
+		int Cameras = 10000;
+		int Keys = 30;
+		int Repeat = 5;
+
+		bool bSweep = false;
+		std::vector<int> Sizes = { 10, 100, 1000, 10000, 100000 };
+		std::vector<int> FPS = { 30, 60 };
+		double MaxError = 0.1;  // FCustomRenderGlobalSettings::MaxKeyError
+		std::string Baseline;
+		double Tolerance = 0.25;
+		std::string Out;
+	};
+
+	std::vector<int> ParseIntList(const char * Text)
+	{
+		std::vector<int> Values;
+		std::stringstream Stream(Text);
+		for (std::string Item; std::getline(Stream, Item, ','); )
+		{
+			if (!Item.empty()) Values.push_back(std::atoi(Item.c_str()));
+		}
+		return Values;
+	}
+
+	bool ParseOptions(int Argc, char ** Argv, Options & Out)
+	{
+		for (int i = 1; i < Argc; i++)
+		{
+			const bool bHasValue = i + 1 < Argc;
+			if (!std::strcmp(Argv[i], "--cameras") && bHasValue) Out.Cameras = std::atoi(Argv[++i]);
+			else if (!std::strcmp(Argv[i], "--keys") && bHasValue) Out.Keys = std::atoi(Argv[++i]);
+			else if (!std::strcmp(Argv[i], "--repeat") && bHasValue) Out.Repeat = std::atoi(Argv[++i]);
+			else if (!std::strcmp(Argv[i], "--sweep")) Out.bSweep = true;
+			else if (!std::strcmp(Argv[i], "--sizes") && bHasValue) Out.Sizes = ParseIntList(Argv[++i]);
+			else if (!std::strcmp(Argv[i], "--fps") && bHasValue) Out.FPS = ParseIntList(Argv[++i]);
+			else if (!std::strcmp(Argv[i], "--max-error") && bHasValue) Out.MaxError = std::atof(Argv[++i]);
+			else if (!std::strcmp(Argv[i], "--baseline") && bHasValue) Out.Baseline = Argv[++i];
+			else if (!std::strcmp(Argv[i], "--tolerance") && bHasValue) Out.Tolerance = std::atof(Argv[++i]);
+			else if (!std::strcmp(Argv[i], "--out") && bHasValue) Out.Out = Argv[++i];
+			else return false;
+		}
+
+		for (int Size : Out.Sizes) if (Size <= 0) return false;
+		for (int FPS : Out.FPS) if (FPS <= 0) return false;
+		return Out.Cameras > 0 && Out.Keys > 0 && Out.Repeat > 0 && !Out.Sizes.empty() && !Out.FPS.empty() && Out.MaxError > 0.0;
+	}
+
+	/** Orbits around a square grid of targets 300 cm apart */
+	std::vector<OrbitParams> MakeOrbits(int NumOrbits)
+	{
+		std::vector<OrbitParams> Orbits;
+		MakeSyntheticOrbits(NumOrbits, Orbits);
+		return Orbits;
+	}
+
+	/** Best wall time in seconds of Repeat calls */
+	double BestOf(int Repeat, const std::function<void()> & Work)
+	{
+		using Clock = std::chrono::steady_clock;
+		double Best = 0.0;
+		for (int r = 0; r < Repeat; r++)
+		{
+			const auto Start = Clock::now();
+			Work();
+			const double Seconds = std::chrono::duration<double>(Clock::now() - Start).count();
+			Best = r == 0 ? Seconds : std::min(Best, Seconds);
+		}
+		return Best;
+	}
+
+	void Report(const char * Name, double Seconds, const Options & O)
+	{
+		const double Keys = double(O.Cameras) * O.Keys;
+		std::printf("%-10s %10.3f ms %12.1f Mkeys/s %10.1f ns/camera\n",
+			Name, Seconds * 1e3, Seconds > 0.0 ? Keys / Seconds * 1e-6 : 0.0, Seconds * 1e9 / O.Cameras);
+	}
+
+	int RunMicrobenchmark(const Options & O)
+	{
+		const std::vector<OrbitParams> Orbits = MakeOrbits(O.Cameras);
+		double Checksum = 0.0;
+
+		std::vector<OrbitKey> Keys;
+		const double ReferenceSeconds = BestOf(O.Repeat, [&]() {
+			for (const OrbitParams & P : Orbits)
+			{
+				GenerateKeys(P, O.Keys, Keys);
+				Checksum += Keys.back().Position.X;
+			}
+		});
+
+		OrbitBatch Batch;
+		Batch.Reserve(Orbits.size());
+		for (const OrbitParams & P : Orbits) Batch.Add(P);
+		OrbitBatchPositions Positions;
+		Positions.Resize(Batch.Num(), O.Keys);
+		const double BatchSeconds = BestOf(O.Repeat, [&]() {
+			EvaluateBatch(Batch, 0, Batch.Num(), Positions);
+			Checksum += Positions.X.back();
+		});
+
+		std::printf("%d cameras, %d keys each, best of %d (SSE2 %d, AVX2 %d)\n", O.Cameras, O.Keys, O.Repeat, ORBITCORE_SSE2, ORBITCORE_AVX2);
+		Report("Reference", ReferenceSeconds, O);
+		Report("Batch", BatchSeconds, O);
+		std::printf("Checksum %g\n", Checksum);
+		return 0;
+	}
+
+	/** Totals of a results file keyed by "Mode,Targets,FPS", like LoadBaseline of the commandlet */
+	bool LoadBaseline(const std::string & Path, std::map<std::string, double> & Totals)
+	{
+		std::ifstream File(Path);
+		if (!File)
+		{
+			std::fprintf(stderr, "Can't read baseline file %s\n", Path.c_str());
+			return false;
+		}
+
+		std::string Line;
+		std::getline(File, Line);
+		while (std::getline(File, Line))
+		{
+			std::vector<std::string> Cells;
+			std::stringstream Stream(Line);
+			for (std::string Cell; Cells.size() < 4 && std::getline(Stream, Cell, ','); ) Cells.push_back(Cell);
+			if (Cells.size() < 4) continue;
+
+			Totals[Cells[0] + "," + Cells[1] + "," + Cells[2]] = std::atof(Cells[3].c_str());
+		}
+		return true;
+	}
+
+	int RunSweep(const Options & O)
+	{
+		std::map<std::string, double> Baseline;
+		if (!O.Baseline.empty() && !LoadBaseline(O.Baseline, Baseline)) return 1;
+
+		std::string Csv = "Mode,Targets,FPS,TotalMs,Details\n";
+		int NumRegressions = 0, NumMissing = 0;
+		for (int Size : O.Sizes)
+		{
+			for (int FPS : O.FPS)
+			{
+				// Best of the repeats for each way of keying, the first run also warms the caches up
+				BenchmarkResult Best = RunBenchmark(Size, FPS, O.MaxError);
+				for (int r = 1; r < O.Repeat; r++)
+				{
+					const BenchmarkResult Result = RunBenchmark(Size, FPS, O.MaxError);
+					Best.ReferenceSeconds = std::min(Best.ReferenceSeconds, Result.ReferenceSeconds);
+					Best.BatchSeconds = std::min(Best.BatchSeconds, Result.BatchSeconds);
+					Best.MinimalSeconds = std::min(Best.MinimalSeconds, Result.MinimalSeconds);
+				}
+
+				char Key[64], Row[256];
+				std::snprintf(Key, sizeof(Key), "Math,%d,%d", Size, FPS);
+				std::snprintf(Row, sizeof(Row), "%s,%.3f,ReferenceMs=%.3f;BatchMs=%.3f;MinimalMs=%.3f;MinimalKeys=%llu\n",
+					Key, Best.BatchSeconds * 1e3, Best.ReferenceSeconds * 1e3, Best.BatchSeconds * 1e3, Best.MinimalSeconds * 1e3,
+					static_cast<unsigned long long>(Best.MinimalKeys));
+				Csv += Row;
+
+				std::printf("Math %d targets at %d FPS: reference %.3f ms, batch %.3f ms, minimal %.3f ms, %llu minimal keys\n",
+					Size, FPS, Best.ReferenceSeconds * 1e3, Best.BatchSeconds * 1e3, Best.MinimalSeconds * 1e3,
+					static_cast<unsigned long long>(Best.MinimalKeys));
+
+				const auto Found = Baseline.find(Key);
+				if (!O.Baseline.empty() && Found == Baseline.end())
+				{
+					NumMissing++;
+					std::printf("%s: %.3f ms, not in the baseline\n", Key, Best.BatchSeconds * 1e3);
+				}
+				else if (Found != Baseline.end())
+				{
+					const double TotalMs = Best.BatchSeconds * 1e3;
+					const double Ratio = Found->second > 0.0 ? TotalMs / Found->second : 1.0;
+					const bool bRegressed = Ratio > 1.0 + O.Tolerance;
+					NumRegressions += bRegressed ? 1 : 0;
+					std::printf("%s: %.3f ms, baseline %.3f ms (x%.2f)%s\n", Key, TotalMs, Found->second, Ratio, bRegressed ? " REGRESSION" : "");
+				}
+			}
+		}
+
+		if (!O.Out.empty())
+		{
+			std::ofstream File(O.Out);
+			if (!(File << Csv))
+			{
+				std::fprintf(stderr, "Can't write %s\n", O.Out.c_str());
+				return 1;
+			}
+			std::printf("Results written to %s\n", O.Out.c_str());
+		}
+
+		if (NumMissing > 0)
+		{
+			std::fprintf(stderr, "%d results have no baseline\n", NumMissing);
+		}
+		if (NumRegressions > 0)
+		{
+			std::fprintf(stderr, "%d results are slower than the baseline by more than %.0f%%\n", NumRegressions, O.Tolerance * 100.0);
+		}
+		return NumMissing > 0 || NumRegressions > 0 ? 1 : 0;
+	}
+}
+
+int main(int Argc, char ** Argv)
+{
+	Options O;
+	if (!ParseOptions(Argc, Argv, O))
+	{
+		std::fprintf(stderr,
+			"Usage: %s [--cameras N] [--keys N] [--repeat N]\n"
+			"       %s --sweep [--sizes N,N,...] [--fps N,N,...] [--max-error CM] [--repeat N]\n"
+			"              [--baseline FILE] [--tolerance RATIO] [--out FILE]\n", Argv[0], Argv[0]);
+		return 1;
+	}
+
+	return O.bSweep ? RunSweep(O) : RunMicrobenchmark(O);
+}
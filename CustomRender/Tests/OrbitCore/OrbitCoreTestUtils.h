@@ -0,0 +1,65 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// The orbit as the editor module computed it before OrbitCore existed, in single precision:
+//
+//   FVector(origin.X, origin.Y, 0) + FVector(0, 0, CameraHeight) + FVector(camRadius, 0, 0).RotateAngleAxis(theta, Zaxis)
+//
+// with theta = StartAngle + t * (EndAngle - StartAngle) and t = time / (fps - 1).
+
+#include "OrbitTrajectory.h"
+
+#include <cmath>
+
+namespace OrbitCoreTest
+{
+	struct FloatVector
+	{
+		float X, Y, Z;
+	};
+
+	/** FVector::RotateAngleAxis */
+	inline FloatVector RotateAngleAxis(const FloatVector & V, float AngleDeg, const FloatVector & Axis)
+	{
+		const float Radians = AngleDeg * (float(OrbitCore::Pi) / 180.0f);
+		const float S = std::sin(Radians), C = std::cos(Radians);
+
+		const float XX = Axis.X * Axis.X, YY = Axis.Y * Axis.Y, ZZ = Axis.Z * Axis.Z;
+		const float XY = Axis.X * Axis.Y, YZ = Axis.Y * Axis.Z, ZX = Axis.Z * Axis.X;
+		const float XS = Axis.X * S, YS = Axis.Y * S, ZS = Axis.Z * S;
+		const float OMC = 1.0f - C;
+
+		return FloatVector{
+			(OMC * XX + C) * V.X + (OMC * XY - ZS) * V.Y + (OMC * ZX + YS) * V.Z,
+			(OMC * XY + ZS) * V.X + (OMC * YY + C) * V.Y + (OMC * YZ - XS) * V.Z,
+			(OMC * ZX - YS) * V.X + (OMC * YZ + XS) * V.Y + (OMC * ZZ + C) * V.Z };
+	}
+
+	/** Camera position at normalized time T the way the original orbit lambda keyed it */
+	inline FloatVector ReferencePosition(const OrbitCore::OrbitParams & P, double T)
+	{
+		const double CamRadius = std::max(P.Extent.X, P.Extent.Y) * P.RadiusMultiplier;
+		const double Theta = P.StartAngle + T * (P.EndAngle - P.StartAngle);
+		const FloatVector Rotated = RotateAngleAxis(FloatVector{ float(CamRadius), 0.0f, 0.0f }, float(Theta), FloatVector{ 0.0f, 0.0f, 1.0f });
+		return FloatVector{ float(P.Origin.X) + Rotated.X, float(P.Origin.Y) + Rotated.Y, float(P.CameraHeight) + Rotated.Z };
+	}
+
+	/** Absolute tolerance for comparing with single precision results around a value of magnitude Scale */
+	inline double FloatTolerance(double Scale)
+	{
+		return 1e-3 + 4e-6 * std::fabs(Scale);
+	}
+
+	/** A spread of orbits: negative and wrapped angles, flat and tall bounds, far from the origin */
+	inline std::vector<OrbitCore::OrbitParams> TestOrbits()
+	{
+		return {
+			{ { 0, 0, 0 }, { 50, 50, 50 }, 3.0, 150.0, 0.0, 180.0 },
+			{ { 1250, -430, 20 }, { 20, 75, 10 }, 1.5, -40.0, -90.0, 270.0 },
+			{ { -8000, 12000, 0 }, { 400, 120, 900 }, 2.0, 600.0, 360.0, 0.0 },
+			{ { 3.5, 7.25, 0 }, { 1, 1, 1 }, 20.0, 0.0, 45.0, 45.0 },
+			{ { 50000, 50000, 0 }, { 300, 300, 300 }, 4.0, 1000.0, -720.0, 720.0 },
+		};
+	}
+}
@@ -0,0 +1,106 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "OrbitTrajectory.h"
+#include "OrbitBatch.h"
+#include "OrbitCoreTestUtils.h"
+
+#include <gtest/gtest.h>
+
+using namespace OrbitCore;
+using namespace OrbitCoreTest;
+
+TEST(Trajectory, RadiusUsesLargerHorizontalExtent)
+{
+	OrbitParams P = { { 0, 0, 0 }, { 20, 75, 500 }, 2.0, 0.0, 0.0, 180.0 };
+	EXPECT_DOUBLE_EQ(OrbitRadius(P), 150.0);
+
+	P.Extent = { 80, 10, 0 };
+	EXPECT_DOUBLE_EQ(OrbitRadius(P), 160.0);
+}
+
+TEST(Trajectory, KeyTimeSpansTheShot)
+{
+	EXPECT_DOUBLE_EQ(KeyTime(0, 30), 0.0);
+	EXPECT_DOUBLE_EQ(KeyTime(29, 30), 1.0);
+	EXPECT_DOUBLE_EQ(KeyTime(10, 21), 0.5);
+	EXPECT_DOUBLE_EQ(KeyTime(0, 1), 0.0);
+}
+
+TEST(Trajectory, KeyFrameTruncatesLikeTheOriginal)
+{
+	const int StartTime = 24000, DeltaTime = 24000;
+	for (int Fps : { 2, 24, 30, 60, 512 })
+	{
+		for (int Time = 0; Time < Fps; Time++)
+		{
+			const double T = double(Time) / double(Fps - 1);
+			EXPECT_EQ(KeyFrame(T, StartTime, DeltaTime), StartTime + int(T * DeltaTime));
+		}
+	}
+}
+
+TEST(Trajectory, EvaluatePositionMatchesRotateAngleAxis)
+{
+	for (const OrbitParams & P : TestOrbits())
+	{
+		for (int Time = 0; Time < 30; Time++)
+		{
+			const double T = KeyTime(Time, 30);
+			const Vec3 Position = EvaluatePosition(P, T);
+			const FloatVector Reference = ReferencePosition(P, T);
+
+			const double Tolerance = FloatTolerance(std::fabs(P.Origin.X) + std::fabs(P.Origin.Y) + OrbitRadius(P));
+			EXPECT_NEAR(Position.X, Reference.X, Tolerance);
+			EXPECT_NEAR(Position.Y, Reference.Y, Tolerance);
+			EXPECT_NEAR(Position.Z, Reference.Z, FloatTolerance(P.CameraHeight));
+		}
+	}
+}
+
+TEST(Trajectory, GenerateKeysStartAndEndOnTheAngles)
+{
+	const OrbitParams P = { { 100, 200, 0 }, { 50, 50, 50 }, 3.0, 150.0, 0.0, 180.0 };
+
+	std::vector<OrbitKey> Keys;
+	GenerateKeys(P, 30, Keys);
+	ASSERT_EQ(Keys.size(), 30u);
+
+	EXPECT_DOUBLE_EQ(Keys.front().T, 0.0);
+	EXPECT_NEAR(Keys.front().Position.X, 250.0, 1e-9);
+	EXPECT_NEAR(Keys.front().Position.Y, 200.0, 1e-9);
+	EXPECT_DOUBLE_EQ(Keys.front().Position.Z, 150.0);
+
+	EXPECT_DOUBLE_EQ(Keys.back().T, 1.0);
+	EXPECT_NEAR(Keys.back().Position.X, -50.0, 1e-9);
+	EXPECT_NEAR(Keys.back().Position.Y, 200.0, 1e-9);
+
+	GenerateKeys(P, 0, Keys);
+	EXPECT_TRUE(Keys.empty());
+}
+
+TEST(Trajectory, EvaluateBatchMatchesRotateAngleAxis)
+{
+	const std::vector<OrbitParams> Orbits = TestOrbits();
+	const int NumKeys = 37;
+
+	OrbitBatch Batch;
+	for (const OrbitParams & P : Orbits) Batch.Add(P);
+
+	OrbitBatchPositions Positions;
+	Positions.Resize(Batch.Num(), NumKeys);
+	EvaluateBatch(Batch, 0, Batch.Num(), Positions);
+
+	for (size_t c = 0; c < Orbits.size(); c++)
+	{
+		const OrbitParams & P = Orbits[c];
+		const double Tolerance = FloatTolerance(std::fabs(P.Origin.X) + std::fabs(P.Origin.Y) + OrbitRadius(P));
+		for (int k = 0; k < NumKeys; k++)
+		{
+			const FloatVector Reference = ReferencePosition(P, KeyTime(k, NumKeys));
+			const size_t Index = Positions.Offset(c) + k;
+			EXPECT_NEAR(Positions.X[Index], Reference.X, Tolerance) << "camera " << c << " key " << k;
+			EXPECT_NEAR(Positions.Y[Index], Reference.Y, Tolerance) << "camera " << c << " key " << k;
+			EXPECT_FLOAT_EQ(Positions.Z[Index], Reference.Z);
+		}
+	}
+}
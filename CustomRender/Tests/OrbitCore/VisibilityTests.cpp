@@ -0,0 +1,77 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "OrbitVisibility.h"
+
+#include <gtest/gtest.h>
+
+using namespace OrbitCore;
+
+TEST(Visibility, RaysArePositionMajorAndFillTheirSlotsOnly)
+{
+	const OrbitParams P = { { 100, -200, 30 }, { 40, 60, 20 }, 2.5, 150.0, 0.0, 180.0 };
+	VisibilityParams V;
+	V.NumPositions = 5;
+
+	// One slot on either side stays untouched
+	const int Num = RaysPerOrbit(V);
+	const VisibilityRay Marker = { { -1, -1, -1 }, { -1, -1, -1 } };
+	std::vector<VisibilityRay> Rays(Num + 2, Marker);
+	WriteVisibilityRays(P, V, Rays.data() + 1);
+	EXPECT_EQ(Rays.front().Start.X, -1.0);
+	EXPECT_EQ(Rays.back().Start.X, -1.0);
+
+	for (int k = 0; k < V.NumPositions; k++)
+	{
+		const Vec3 Position = EvaluatePosition(P, KeyTime(k, V.NumPositions));
+		for (int p = 0; p < NumTargetPoints; p++)
+		{
+			const VisibilityRay & Ray = Rays[1 + k * NumTargetPoints + p];
+			EXPECT_DOUBLE_EQ(Ray.Start.X, Position.X);
+			EXPECT_DOUBLE_EQ(Ray.Start.Y, Position.Y);
+			EXPECT_DOUBLE_EQ(Ray.Start.Z, Position.Z);
+
+			// The center first, then the corners of the scaled bounds
+			EXPECT_LE(std::fabs(Ray.End.X - P.Origin.X), P.Extent.X * V.PointScale + 1e-9);
+			EXPECT_LE(std::fabs(Ray.End.Y - P.Origin.Y), P.Extent.Y * V.PointScale + 1e-9);
+			EXPECT_LE(std::fabs(Ray.End.Z - P.Origin.Z), P.Extent.Z * V.PointScale + 1e-9);
+			if (p == 0) { EXPECT_DOUBLE_EQ(Ray.End.X, P.Origin.X); }
+			else { EXPECT_DOUBLE_EQ(std::fabs(Ray.End.Z - P.Origin.Z), P.Extent.Z * V.PointScale); }
+		}
+	}
+}
+
+TEST(Visibility, PositionVisibilityCountsEachPosition)
+{
+	VisibilityParams V;
+	V.NumPositions = 3;
+
+	// All, none and two thirds of the points seen
+	std::vector<uint8_t> Visible(RaysPerOrbit(V), 0);
+	for (int p = 0; p < NumTargetPoints; p++) Visible[p] = 1;
+	for (int p = 0; p < 6; p++) Visible[2 * NumTargetPoints + p] = 1;
+
+	std::vector<double> PerPosition;
+	PositionVisibility(Visible.data(), V, PerPosition);
+	ASSERT_EQ(PerPosition.size(), 3u);
+	EXPECT_DOUBLE_EQ(PerPosition[0], 1.0);
+	EXPECT_DOUBLE_EQ(PerPosition[1], 0.0);
+	EXPECT_DOUBLE_EQ(PerPosition[2], 6.0 / NumTargetPoints);
+	EXPECT_DOUBLE_EQ(MeanVisibility(PerPosition), (1.0 + 6.0 / NumTargetPoints) / 3.0);
+}
+
+TEST(Visibility, TrimKeepsTheLongestVisibleRun)
+{
+	const OrbitParams P = { { 0, 0, 0 }, { 50, 50, 50 }, 2.0, 100.0, 0.0, 180.0 };
+
+	// Positions 1 and 2, then 4 to 6 are visible, the second run wins
+	const std::vector<double> PerPosition = { 0.0, 1.0, 0.8, 0.1, 0.7, 0.9, 1.0, 0.2, 0.0 };
+	OrbitParams Trimmed;
+	double TrimmedVisibility = 0.0;
+	ASSERT_TRUE(TrimToVisibleArc(P, PerPosition, 0.6, Trimmed, TrimmedVisibility));
+	EXPECT_DOUBLE_EQ(Trimmed.StartAngle, KeyTime(4, 9) * 180.0);
+	EXPECT_DOUBLE_EQ(Trimmed.EndAngle, KeyTime(6, 9) * 180.0);
+	EXPECT_NEAR(TrimmedVisibility, (0.7 + 0.9 + 1.0) / 3.0, 1e-12);
+
+	// A single visible position is no arc
+	EXPECT_FALSE(TrimToVisibleArc(P, { 0.0, 1.0, 0.0 }, 0.6, Trimmed, TrimmedVisibility));
+}